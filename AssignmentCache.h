@@ -0,0 +1,164 @@
+/**
+ * @file AssignmentCache.h
+ * @brief Cache des résultats d'association partagé par Hungarian.cpp et NaiveAlgorithme.cpp.
+ * 
+ * Chaque fichier compilé par sourceCpp possède sa propre instance du cache ; seul le code est partagé.
+ */
+#ifndef ASSIGNMENT_CACHE_H
+#define ASSIGNMENT_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <Rcpp.h>
+
+
+/**
+ * @brief Calcule une empreinte 64 bits des dimensions et du contenu d'une matrice.
+ * 
+ * @param matrix La matrice à hacher.
+ * @return L'empreinte de la matrice.
+ */
+inline std::uint64_t hash_matrix(const std::vector<std::vector<int>>& matrix)
+{
+    std::uint64_t hash = 0x9E3779B97F4A7C15ULL ^ matrix.size(); // Graine mélangée avec le nombre de lignes
+    for (const auto& row: matrix) {
+        hash = (hash ^ row.size()) * 0xFF51AFD7ED558CCDULL;
+        for (int element: row) {
+            hash ^= (std::uint32_t)element;
+            hash *= 0x100000001B3ULL; // Multiplication FNV
+            hash ^= hash >> 29;
+        }
+    }
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    return hash ^ (hash >> 33);
+}
+
+
+/**
+ * @brief Cache borné des résultats d'association, évincé par ordre d'utilisation (LRU).
+ * 
+ * Les entrées sont indexées par l'empreinte de la matrice ; la matrice elle-même est conservée pour qu'une
+ * collision d'empreintes ne renvoie jamais le résultat d'un autre problème. Le cache est borné à la fois en
+ * nombre d'entrées et en octets (matrices et résultats conservés), l'éviction continuant tant que l'une des deux
+ * limites est dépassée. Toutes les opérations sont protégées par un verrou, le calcul lui-même se faisant hors
+ * du verrou.
+ */
+class AssignmentCache {
+public:
+    AssignmentCache(std::size_t max_entries, std::size_t max_bytes) : capacity(max_entries), byte_capacity(max_bytes) {}
+
+    // Cherche le résultat d'une matrice ; renvoie true et remplit result en cas de succès
+    bool lookup(const std::vector<std::vector<int>>& matrix, std::uint64_t key, std::vector<std::vector<int>>& result)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto found = index.find(key);
+        if (found == index.end() || found->second->matrix != matrix) {
+            misses++;
+            return false;
+        }
+        entries.splice(entries.begin(), entries, found->second); // Marquer l'entrée comme la plus récente
+        result = found->second->result;
+        hits++;
+        return true;
+    }
+
+    // Enregistre le résultat d'une matrice en évinçant les entrées les moins récentes si nécessaire
+    void store(const std::vector<std::vector<int>>& matrix, std::uint64_t key, const std::vector<std::vector<int>>& result)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::size_t entry_bytes = matrix_bytes(matrix) + matrix_bytes(result);
+        if (capacity == 0 || entry_bytes > byte_capacity) // L'entrée seule dépasserait le budget
+            return;
+        auto found = index.find(key);
+        if (found != index.end()) { // Remplacer l'entrée existante (mise à jour ou collision)
+            bytes -= found->second->bytes;
+            entries.erase(found->second);
+            index.erase(found);
+        }
+        entries.push_front(Entry{key, matrix, result, entry_bytes});
+        bytes += entry_bytes;
+        index[key] = entries.begin();
+        evict();
+    }
+
+    void set_capacity(std::size_t new_capacity)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        capacity = new_capacity;
+        evict();
+    }
+
+    void set_byte_capacity(std::size_t new_byte_capacity)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        byte_capacity = new_byte_capacity;
+        evict();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        entries.clear();
+        index.clear();
+        bytes = 0;
+        hits = 0;
+        misses = 0;
+    }
+
+    Rcpp::List stats()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return Rcpp::List::create(
+            Rcpp::Named("hits") = (double)hits,
+            Rcpp::Named("misses") = (double)misses,
+            Rcpp::Named("size") = (int)entries.size(),
+            Rcpp::Named("capacity") = (int)capacity,
+            Rcpp::Named("bytes") = (double)bytes,
+            Rcpp::Named("max_bytes") = (double)byte_capacity
+        );
+    }
+
+private:
+    struct Entry {
+        std::uint64_t key;
+        std::vector<std::vector<int>> matrix;
+        std::vector<std::vector<int>> result;
+        std::size_t bytes; // Taille des deux matrices
+    };
+
+    // Nombre d'octets occupés par les éléments d'une matrice
+    static std::size_t matrix_bytes(const std::vector<std::vector<int>>& matrix)
+    {
+        std::size_t cells = 0;
+        for (const auto& row: matrix)
+            cells += row.size();
+        return cells * sizeof(int);
+    }
+
+    // Retirer les entrées les moins récentes au-delà de la capacité ou du budget en octets (verrou déjà pris)
+    void evict()
+    {
+        while (!entries.empty() && (entries.size() > capacity || bytes > byte_capacity)) {
+            bytes -= entries.back().bytes;
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+    }
+
+    std::size_t capacity;
+    std::size_t byte_capacity;
+    std::size_t bytes = 0;
+    std::list<Entry> entries; // De la plus récente à la moins récente
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> index;
+    std::mutex lock;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+};
+
+#endif // ASSIGNMENT_CACHE_H
@@ -10,6 +10,13 @@
 #include <chrono> // Pour mesurer le temps
 #include <numeric>
 #include <random>
+#include <atomic>
+#include <thread>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <cstdint>
 
 using namespace std;
 using namespace std::chrono;
@@ -17,6 +24,8 @@ using namespace std::chrono;
 #include <Rcpp.h>
 using namespace Rcpp;
 
+#include "AssignmentCache.h" // Cache des résultats partagé avec NaiveAlgorithme.cpp
+
 
 // Fonction pour imprimer une chaîne de caractères
 void print(const string& message) {
@@ -101,6 +110,22 @@ void adjust_matrix(vector<vector<T>>& matrix)
     }
 }
 
+/**
+ * @brief Indique si une case de la matrice correspond à une association interdite.
+ * 
+ * Une association interdite est codée par la valeur maximale du type T, la même valeur que celle utilisée
+ * par adjust_matrix pour les éléments fictifs.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param value La valeur de la case.
+ * @return true si l'association est interdite, sinon false.
+ */
+template<typename T>
+inline bool is_forbidden(T value)
+{
+    return value == numeric_limits<T>::max();
+}
+
 /**
  * @brief Pour chaque ligne de la matrice, trouver le plus petit élément et le soustraire à chaque élément de sa ligne.
  * Pour chaque colonne de la matrice, trouver le plus petit élément et le soustraire à chaque élément de sa colonne. Passer à l'étape 2.
@@ -196,6 +221,137 @@ void step2(const vector<vector<T>>& matrix, vector<vector<int>>& M, vector<int>&
 }
 
 
+/**
+ * @brief Calcule un couplage biparti de cardinalité maximale par l'algorithme de Hopcroft–Karp.
+ * 
+ * Le graphe est donné sous forme compressée : les colonnes voisines de la ligne r sont adj[start[r]..start[r+1]-1].
+ * Les couplages déjà présents dans match_row et match_col sont conservés comme point de départ, ce qui permet
+ * de reprendre un couplage précédent. Le parcours en profondeur est itératif pour éviter de saturer la pile.
+ * 
+ * @param start Les débuts des listes de voisins de chaque ligne (taille rows + 1).
+ * @param adj Les colonnes voisines, ligne par ligne.
+ * @param match_row La colonne associée à chaque ligne, ou -1 (modifié par référence).
+ * @param match_col La ligne associée à chaque colonne, ou -1 (modifié par référence).
+ * @return La taille du couplage obtenu.
+ */
+int hopcroft_karp(const vector<int>& start, const vector<int>& adj, vector<int>& match_row, vector<int>& match_col)
+{
+    int rows = match_row.size();
+    const int unreached = numeric_limits<int>::max();
+    vector<int> dist(rows);
+    vector<int> next_arc(rows);
+    vector<int> queue(rows);
+    vector<int> stack;
+
+    int matching = 0;
+    for (int r = 0; r < rows; ++r)
+        if (match_row[r] != -1)
+            matching++;
+
+    while (true) {
+        // Parcours en largeur depuis les lignes libres pour construire les niveaux
+        int head = 0;
+        int tail = 0;
+        for (int r = 0; r < rows; ++r) {
+            dist[r] = match_row[r] == -1 ? 0 : unreached;
+            if (match_row[r] == -1)
+                queue[tail++] = r;
+        }
+        bool found = false;
+        while (head < tail) {
+            int r = queue[head++];
+            for (int a = start[r]; a < start[r + 1]; ++a) {
+                int next = match_col[adj[a]];
+                if (next == -1)
+                    found = true; // Une colonne libre est atteignable
+                else if (dist[next] == unreached) {
+                    dist[next] = dist[r] + 1;
+                    queue[tail++] = next;
+                }
+            }
+        }
+        if (!found)
+            break; // Plus aucun chemin augmentant : le couplage est maximal
+
+        // Parcours en profondeur le long des niveaux pour trouver des chemins augmentants disjoints
+        for (int r = 0; r < rows; ++r)
+            next_arc[r] = start[r];
+        for (int root = 0; root < rows; ++root) {
+            if (match_row[root] != -1 || dist[root] != 0)
+                continue;
+            stack.assign(1, root);
+            while (!stack.empty()) {
+                int r = stack.back();
+                if (next_arc[r] == start[r + 1]) { // Impasse : retirer la ligne des niveaux
+                    dist[r] = unreached;
+                    stack.pop_back();
+                    continue;
+                }
+                int next = match_col[adj[next_arc[r]]];
+                if (next == -1) {
+                    // Inverser le chemin : chaque ligne de la pile prend la colonne qu'elle explore
+                    for (int row: stack) {
+                        int col = adj[next_arc[row]];
+                        match_row[row] = col;
+                        match_col[col] = row;
+                    }
+                    matching++;
+                    break;
+                }
+                if (dist[next] == dist[r] + 1)
+                    stack.push_back(next);
+                else
+                    next_arc[r]++;
+            }
+        }
+    }
+
+    return matching;
+}
+
+
+/**
+ * @brief Variante de l'étape 2 qui étoile un ensemble maximal de zéros indépendants.
+ * 
+ * Au lieu d'étoiler les zéros dans l'ordre des lignes, cette variante construit en une passe la liste des zéros
+ * de chaque ligne et calcule un couplage de cardinalité maximale sur ces zéros par Hopcroft–Karp. Chaque zéro
+ * étoilé supplémentaire par rapport à step2 économise un cycle complet des étapes 4, 5 et 6.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice d'entrée.
+ * @param M La matrice de masquage (modifiée par référence).
+ * @param step Un compteur de l'étape actuelle de l'algorithme (modifié par référence).
+ */
+template<typename T>
+void step2_maximum_matching(const vector<vector<T>>& matrix, vector<vector<int>>& M, int& step)
+{
+    int size = matrix.size(); // Taille de la matrice
+
+    // Graphe des zéros au format compressé par lignes
+    vector<int> start(size + 1, 0);
+    vector<int> zeros;
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            if (matrix[row][col] == 0)
+                zeros.push_back(col);
+        }
+        start[row + 1] = zeros.size();
+    }
+
+    vector<int> match_row(size, -1);
+    vector<int> match_col(size, -1);
+    hopcroft_karp(start, zeros, match_row, match_col);
+
+    // Étoiler les zéros du couplage
+    for (int row = 0; row < size; ++row) {
+        if (match_row[row] != -1)
+            M[row][match_row[row]] = 1;
+    }
+
+    step = 3; // Passer à l'étape 3 de l'algorithme
+}
+
+
 /**
  * @brief Couvrir chaque colonne contenant un zéro étoilé. Si K colonnes sont couvertes, les zéros étoilés décrivent un ensemble complet
  * d'associations uniques. Dans ce cas, aller à TERMINÉ, sinon, aller à l'étape 4. Une fois que nous avons parcouru l'ensemble de la matrice
@@ -338,6 +494,32 @@ void find_starred_zero_in_row(int row, int& col, const vector<vector<int>>& M)
     }
 }
 
+/**
+ * @brief Jeton d'annulation coopérative partagé entre un solveur et son appelant.
+ * 
+ * Le solveur interroge should_stop() aux frontières d'étapes et dans les boucles longues. L'arrêt est demandé
+ * par cancel() (depuis un autre thread), par le dépassement de la date limite, ou par la fonction interrupt
+ * (par exemple une interruption de l'utilisateur R), interrogée seulement toutes les 256 vérifications.
+ */
+struct CancellationToken {
+    atomic<bool> cancelled{false};                                     // Annulation demandée
+    steady_clock::time_point deadline = steady_clock::time_point::max(); // Date limite de la résolution
+    bool (*interrupt)() = nullptr;                                     // Vérification externe optionnelle
+    unsigned checks = 0;                                               // Nombre de vérifications effectuées
+
+    void cancel() { cancelled = true; }
+
+    bool should_stop()
+    {
+        if (cancelled)
+            return true;
+        if (steady_clock::now() >= deadline || (interrupt && (++checks & 255) == 0 && interrupt()))
+            cancelled = true;
+        return cancelled;
+    }
+};
+
+
 /**
  * @brief Trouver un zéro non couvert et le primariser. Si aucun zéro étoilé n'existe dans la ligne contenant ce zéro primarisé, aller à l'étape 5.
  * Sinon, couvrir cette ligne et découvrir la colonne contenant le zéro étoilé. Continuer de cette manière jusqu'à ce qu'il n'y ait plus de zéros non couverts
@@ -351,9 +533,11 @@ void find_starred_zero_in_row(int row, int& col, const vector<vector<int>>& M)
  * @param path_row_0 L'indice de la ligne du zéro primarisé (modifié par référence).
  * @param path_col_0 L'indice de la colonne du zéro primarisé (modifié par référence).
  * @param step Un compteur de l'étape actuelle de l'algorithme (modifié par référence).
+ * @param token Le jeton d'annulation optionnel, vérifié après chaque zéro primarisé ; en cas d'arrêt, l'étape reste 4
+ * et peut être reprise telle quelle. Au moins un zéro est traité par appel, ce qui garantit la progression.
  */
 template<typename T>
-void step4(const vector<vector<T>>& matrix, vector<vector<int>>& M, vector<int>& RowCover, vector<int>& ColCover, int& path_row_0, int& path_col_0, int& step)
+void step4(const vector<vector<T>>& matrix, vector<vector<int>>& M, vector<int>& RowCover, vector<int>& ColCover, int& path_row_0, int& path_col_0, int& step, CancellationToken* token = nullptr)
 {
     int row = -1; // L'indice de ligne du zéro non couvert initialisé à -1
     int col = -1; // L'indice de colonne du zéro non couvert initialisé à -1
@@ -361,6 +545,9 @@ void step4(const vector<vector<T>>& matrix, vector<vector<int>>& M, vector<int>&
 
     while (!done) { // Boucle jusqu'à ce qu'un zéro non couvert soit trouvé ou que toute la matrice soit parcourue
 
+        if (row != -1 && token && token->should_stop()) // Jamais avant le premier zéro traité
+            return; // Les zéros primarisés et les couvertures déjà posés suffisent pour reprendre l'étape 4
+
         find_uncovered_zero(row, col, matrix, RowCover, ColCover); // Trouver un zéro non couvert dans la matrice
 
         if (row == -1) { // Si aucun zéro non couvert n'est trouvé dans la matrice
@@ -540,11 +727,15 @@ void step5(vector<vector<int>>& path, int path_row_0, int path_col_0, vector<vec
  * @param matrix La matrice dans laquelle chercher la plus petite valeur.
  * @param RowCover Le vecteur de couverture des lignes.
  * @param ColCover Le vecteur de couverture des colonnes.
+ * @param token Le jeton d'annulation optionnel, vérifié à chaque ligne.
+ * @return false si la recherche a été arrêtée avant la fin (minval est alors incomplet).
  */
 template<typename T>
-void find_smallest(T& minval, const vector<vector<T>>& matrix, const vector<int>& RowCover, const vector<int>& ColCover)
+bool find_smallest(T& minval, const vector<vector<T>>& matrix, const vector<int>& RowCover, const vector<int>& ColCover, CancellationToken* token = nullptr)
 {
     for (unsigned r = 0; r < matrix.size(); r++) { // Parcourir chaque ligne de la matrice
+        if (token && token->should_stop())
+            return false;
         for (unsigned c = 0; c < matrix.size(); c++) { // Parcourir chaque colonne de la matrice
             // Vérifier si la valeur à la position [r][c] est non couverte par les vecteurs de couverture
             if (RowCover[r] == 0 && ColCover[c] == 0) {
@@ -555,6 +746,7 @@ void find_smallest(T& minval, const vector<vector<T>>& matrix, const vector<int>
             }
         }
     }
+    return true;
 }
 
 
@@ -565,20 +757,37 @@ void find_smallest(T& minval, const vector<vector<T>>& matrix, const vector<int>
  * 
  * @tparam T Le type des éléments de la matrice.
  * @param matrix La matrice à modifier.
+ * Le jeton est vérifié à chaque ligne. Un arrêt pendant la recherche du minimum ne modifie rien ; un arrêt pendant
+ * la mise à jour conserve la prochaine ligne à traiter et le minimum, si bien que l'appel suivant termine la mise à
+ * jour sans refaire la recherche. Au moins une ligne est mise à jour une fois le minimum connu.
+ * 
+ * @tparam T Le type des éléments de la matrice.
+ * @param matrix La matrice à modifier.
  * @param RowCover Le vecteur de couverture des lignes.
  * @param ColCover Le vecteur de couverture des colonnes.
  * @param step Le compteur de l'étape actuelle de l'algorithme (modifié par référence).
+ * @param next_row La prochaine ligne à mettre à jour, 0 si la recherche du minimum reste à faire (modifiée par référence).
+ * @param min_value La plus petite valeur non couverte, conservée entre deux appels (modifiée par référence).
+ * @param token Le jeton d'annulation optionnel.
  */
 template<typename T>
-void step6(vector<vector<T>>& matrix, const vector<int>& row_cover, const vector<int>& col_cover, int& step)
+void step6(vector<vector<T>>& matrix, const vector<int>& row_cover, const vector<int>& col_cover, int& step, int& next_row, T& min_value, CancellationToken* token = nullptr)
 {
-    // Trouver la plus petite valeur non couverte dans la matrice
-    T min_value = numeric_limits<T>::max();
-    find_smallest(min_value, matrix, row_cover, col_cover);
+    if (next_row == 0) {
+        // Trouver la plus petite valeur non couverte dans la matrice
+        min_value = numeric_limits<T>::max();
+        if (!find_smallest(min_value, matrix, row_cover, col_cover, token))
+            return; // Rien n'a été modifié : l'étape 6 sera reprise depuis le début
+    }
     
     int size = matrix.size();
+    int first_row = next_row;
     // Parcourir chaque élément de la matrice
-    for (int r = 0; r < size; r++) {
+    for (int r = first_row; r < size; r++) {
+        if (r > first_row && token && token->should_stop()) {
+            next_row = r; // Lignes [0, r) déjà mises à jour
+            return;
+        }
         for (int c = 0; c < size; c++) {
             // Si la ligne est couverte, ajouter la plus petite valeur non couverte à chaque élément de la ligne
             if (row_cover[r] == 1)
@@ -590,50 +799,78 @@ void step6(vector<vector<T>>& matrix, const vector<int>& row_cover, const vector
     }
     
     // Revenir à l'étape 4 de l'algorithme
+    next_row = 0;
     step = 4;
 }
 
 
 /**
- * @brief Implémente l'algorithme de l'Algorithme hongrois pour résoudre le problème d'association.
- * 
- * @param matrix La matrice d'entrée du problème.
- * @param verbose Indique si les étapes intermédiaires doivent être affichées (par défaut false).
- * @return La valeur de la solution trouvée.
+ * @brief État complet de l'algorithme hongrois, suffisant pour interrompre une résolution puis la reprendre.
  */
-// [[Rcpp::export]]
-vector<vector<int>> Hungarian(vector<vector<int>> matrix, bool verbose = false){
+struct HungarianState {
+    vector<vector<int>> matrix;  // Matrice carrée réduite (les variables duales y sont implicites)
+    vector<vector<int>> M;       // Matrice masquée : 1 pour les zéros étoilés, 2 pour les zéros primés
+    vector<int> RowCover;        // Couverture des lignes
+    vector<int> ColCover;        // Couverture des colonnes
+    vector<vector<int>> path;    // Tableau pour l'algorithme du chemin augmentant
+    int path_row_0 = 0;          // Ligne du zéro primarisé qui commence le chemin
+    int path_col_0 = 0;          // Colonne du zéro primarisé qui commence le chemin
+    int step = 1;                // Prochaine étape à exécuter
+    int augmentations = 0;       // Nombre de passages par l'étape 5
+    int step6_row = 0;           // Prochaine ligne à mettre à jour par une étape 6 interrompue (0 : aucune)
+    int step6_min = 0;           // Plus petite valeur non couverte de l'étape 6 interrompue
+};
 
-    // Copie de la matrice originale
-    vector<vector<int>> original_matrix;
-    copy_matrix(matrix, original_matrix);
 
+/**
+ * @brief Prépare l'état initial de l'algorithme hongrois pour une matrice de coûts.
+ * 
+ * @param matrix La matrice d'entrée du problème (convertie en matrice carrée).
+ * @return L'état prêt à exécuter l'étape 1.
+ */
+HungarianState make_hungarian_state(vector<vector<int>> matrix)
+{
     // Conversion de la matrice en une matrice carrée
     adjust_matrix(matrix);
     size_t sz = matrix.size();
 
-    // Matrice masquée M : 1 pour les zéros étoilés, 2 pour les zéros primés
-    vector<vector<int>> M(sz, vector<int>(sz, 0));
-
-    // Vecteurs de couverture des lignes et des colonnes
-    vector<int> RowCover(sz, 0);
-    vector<int> ColCover(sz, 0);
-
-    // Variables temporaires pour stocker la plus petite valeur non couverte
-    int path_row_0, path_col_0;
+    HungarianState state;
+    state.matrix = move(matrix);
+    state.M.assign(sz, vector<int>(sz, 0));
+    state.RowCover.assign(sz, 0);
+    state.ColCover.assign(sz, 0);
+    // Au plus 2n+1 zéros primarisés et étoilés alternés
+    state.path.assign(2 * sz + 1, vector<int>(2, 0));
+    return state;
+}
 
-    // Tableau pour l'algorithme du chemin augmentant
-    vector<vector<int>> path(sz + 1, vector<int>(2, 0));
 
-    // Affichage de la matrice d'entrée si verbose est activé
-    if (verbose) {
-        print(matrix);
-        print("----------");
-    }
+/**
+ * @brief Exécute les étapes de l'algorithme hongrois jusqu'à la fin ou jusqu'à une demande d'arrêt.
+ * 
+ * Le jeton est vérifié avant chaque étape, dans la boucle de l'étape 4 et à chaque ligne des parcours de l'étape 6.
+ * Une étape interrompue conserve de quoi être reprise plus tard par un nouvel appel. La première étape d'un appel
+ * ignore le jeton (l'étape 4 traite au moins un zéro), si bien que chaque appel progresse même avec une date
+ * limite déjà dépassée.
+ * 
+ * @param state L'état de la résolution (modifié par référence).
+ * @param token Le jeton d'annulation optionnel.
+ * @param verbose Indique si les étapes intermédiaires doivent être affichées.
+ * @param maximum_matching Indique si l'étape 2 étoile un couplage maximal de zéros par Hopcroft–Karp.
+ * @return true si la solution est trouvée, false si la résolution a été arrêtée avant.
+ */
+bool hungarian_run(HungarianState& state, CancellationToken* token = nullptr, bool verbose = false, bool maximum_matching = false)
+{
+    vector<vector<int>>& matrix = state.matrix;
+    vector<vector<int>>& M = state.M;
+    int& step = state.step;
 
     bool done = false;
-    int step = 1;
+    bool first = true; // La première étape progresse toujours, quel que soit le jeton
     while (!done) {
+        if (!first && token && token->should_stop())
+            return false;
+
         switch (step) {
             case 1:
                 step1(matrix, step);
@@ -643,35 +880,39 @@ vector<vector<int>> Hungarian(vector<vector<int>> matrix, bool verbose = false){
                 }
                 break;
             case 2:
-                step2(matrix, M, RowCover, ColCover, step);
+                if (maximum_matching)
+                    step2_maximum_matching(matrix, M, step);
+                else
+                    step2(matrix, M, state.RowCover, state.ColCover, step);
                 if (verbose) {
                     print(matrix);
                     print("----------Step : ", 2);
                 }
                 break;
             case 3:
-                step3(M, ColCover, step);
+                step3(M, state.ColCover, step);
                 if (verbose) {
                     print(matrix);
                     print("----------Step : ", 3);
                 }
                 break;
             case 4:
-                step4(matrix, M, RowCover, ColCover, path_row_0, path_col_0, step);
+                step4(matrix, M, state.RowCover, state.ColCover, state.path_row_0, state.path_col_0, step, token);
                 if (verbose) {
                     print(matrix);
                     print("----------Step : ", 4);
                 }
                 break;
             case 5:
-                step5(path, path_row_0, path_col_0, M, RowCover, ColCover, step);
+                step5(state.path, state.path_row_0, state.path_col_0, M, state.RowCover, state.ColCover, step);
+                state.augmentations++;
                 if (verbose) {
                     print(matrix);
                     print("----------Step : ", 5);
                 }
                 break;
             case 6:
-                step6(matrix, RowCover, ColCover, step);
+                step6(matrix, state.RowCover, state.ColCover, step, state.step6_row, state.step6_min, first ? nullptr : token);
                 if (verbose) {
                     print(matrix);
                     print("----------Step : ", 6);
@@ -688,6 +929,7 @@ vector<vector<int>> Hungarian(vector<vector<int>> matrix, bool verbose = false){
                     print(matrix);
                     print("Assignments Matrix:");
                     print(M);
+                    print("Augmentations : ", state.augmentations);
                     print("----------Final Step : ", 7);
                 }
                 done = true;
@@ -700,72 +942,2276 @@ vector<vector<int>> Hungarian(vector<vector<int>> matrix, bool verbose = false){
                 done = true;
                 break;
         }
+        first = false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Implémente l'algorithme de l'Algorithme hongrois pour résoudre le problème d'association.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si les étapes intermédiaires doivent être affichées (par défaut false).
+ * @param maximum_matching Indique si l'étape 2 étoile un couplage maximal de zéros par Hopcroft–Karp (par défaut false).
+ * @return La valeur de la solution trouvée.
+ */
+// [[Rcpp::export]]
+vector<vector<int>> Hungarian(vector<vector<int>> matrix, bool verbose = false, bool maximum_matching = false){
+
+    HungarianState state = make_hungarian_state(matrix);
+
+    // Affichage de la matrice d'entrée si verbose est activé
+    if (verbose) {
+        print(state.matrix);
+        print("----------");
     }
 
+    hungarian_run(state, nullptr, verbose, maximum_matching);
+
     // Calcul de la valeur de la solution
-    return M;
+    return state.M;
 }
 
 
-// Fonction pour générer une matrice de taille n x n en fonction de k
-vector<vector<int>> generateMatrix(int n, int k) {
-    // Initialisation de la matrice avec des valeurs nulles
-    vector<vector<int>> matrix(n, vector<int>(n, 0));
+/**
+ * @brief Vérifie si l'utilisateur R a demandé une interruption (Ctrl-C), sans saut non local hors du solveur.
+ * 
+ * R_CheckUserInterrupt est exécuté dans R_ToplevelExec, qui capture l'interruption au lieu de quitter la fonction.
+ * Ne doit être appelée que depuis le thread principal de R.
+ */
+static void check_interrupt(void*)
+{
+    R_CheckUserInterrupt();
+}
 
-    // Parcours de chaque élément de la matrice
-    for (int i = 0; i < n * n; ++i) {
-        // Calcul du numéro de ligne et de colonne en fonction de l'indice i
-        int row = i / n;
-        int col = i % n;
+bool user_interrupted()
+{
+    return R_ToplevelExec(check_interrupt, nullptr) == FALSE;
+}
 
-        // Calcul de la valeur de la cellule en fonction de i, row, col et k
-        matrix[row][col] = i + (row + col) % k;
+
+/**
+ * @brief Convertit l'état d'une résolution en liste R, avec les variables duales et le couplage courant.
+ * 
+ * Les variables duales sont déduites de la différence entre la matrice originale et la matrice réduite,
+ * qui vaut u[i] + v[j] pour chaque case (la première variable duale de colonne est fixée à zéro). Si l'étape 6
+ * a été interrompue pendant sa mise à jour, les lignes restantes sont comptées comme déjà mises à jour.
+ * 
+ * @param state L'état de la résolution.
+ * @param original La matrice originale, ajustée en matrice carrée.
+ * @param done Indique si la résolution est terminée.
+ * @param interrupted Indique si l'arrêt vient d'une interruption de l'utilisateur.
+ * @return La liste décrivant l'état, réutilisable par HungarianResume.
+ */
+List hungarian_state_to_list(const HungarianState& state, const vector<vector<int>>& original, bool done, bool interrupted)
+{
+    size_t sz = state.matrix.size();
+    // Valeur réduite d'une case une fois l'éventuelle étape 6 interrompue terminée
+    auto reduced = [&](size_t r, size_t c) {
+        double value = state.matrix[r][c];
+        if (state.step6_row > 0 && r >= (size_t)state.step6_row)
+            value += (state.RowCover[r] == 1 ? state.step6_min : 0) - (state.ColCover[c] == 0 ? state.step6_min : 0);
+        return value;
+    };
+    vector<double> row_duals(sz);
+    vector<double> col_duals(sz);
+    for (size_t r = 0; r < sz; ++r)
+        row_duals[r] = (double)original[r][0] - reduced(r, 0);
+    for (size_t c = 0; c < sz; ++c)
+        col_duals[c] = (double)original[0][c] - reduced(0, c) - row_duals[0];
+
+    // Couplage courant : uniquement les zéros étoilés
+    vector<vector<int>> assignment(state.M);
+    for (auto& row: assignment)
+        for (auto& value: row)
+            value = value == 1 ? 1 : 0;
+
+    return List::create(
+        Named("done") = done,
+        Named("interrupted") = interrupted,
+        Named("assignment") = assignment,
+        Named("row_duals") = row_duals,
+        Named("col_duals") = col_duals,
+        Named("original") = original,
+        Named("matrix") = state.matrix,
+        Named("M") = state.M,
+        Named("RowCover") = state.RowCover,
+        Named("ColCover") = state.ColCover,
+        Named("step") = state.step,
+        Named("path_row_0") = state.path_row_0,
+        Named("path_col_0") = state.path_col_0,
+        Named("augmentations") = state.augmentations,
+        Named("step6_row") = state.step6_row,
+        Named("step6_min") = state.step6_min
+    );
+}
+
+
+/**
+ * @brief Exécute une résolution interruptible et renvoie son état sous forme de liste R.
+ */
+List run_resumable(HungarianState& state, const vector<vector<int>>& original, double time_limit_ms, bool verbose)
+{
+    CancellationToken token;
+    token.interrupt = user_interrupted;
+    if (time_limit_ms > 0)
+        token.deadline = steady_clock::now() + duration_cast<steady_clock::duration>(duration<double, milli>(time_limit_ms));
+
+    bool done = hungarian_run(state, &token, verbose);
+    bool interrupted = !done && steady_clock::now() < token.deadline;
+    if (verbose && !done)
+        print(interrupted ? "Interrupted at step : " : "Time limit reached at step : ", state.step);
+
+    return hungarian_state_to_list(state, original, done, interrupted);
+}
+
+
+/**
+ * @brief Démarre une résolution de l'algorithme hongrois qui peut être interrompue puis reprise.
+ * 
+ * La résolution s'arrête à la première frontière d'étape (ou dans la boucle de l'étape 4) après la date limite
+ * ou après une interruption de l'utilisateur R, et renvoie alors son état partiel.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param time_limit_ms La durée maximale en millisecondes (0 pour aucune limite).
+ * @param verbose Indique si les étapes intermédiaires doivent être affichées (par défaut false).
+ * @return Une liste contenant done, l'affectation courante, les variables duales et l'état à passer à HungarianResume.
+ */
+// [[Rcpp::export]]
+List HungarianStart(vector<vector<int>> matrix, double time_limit_ms = 0, bool verbose = false)
+{
+    HungarianState state = make_hungarian_state(matrix);
+    vector<vector<int>> original(state.matrix);
+    return run_resumable(state, original, time_limit_ms, verbose);
+}
+
+
+/**
+ * @brief Vérifie qu'un état reçu de R est cohérent avant de reprendre la résolution.
+ * 
+ * Toutes les matrices doivent être carrées et de même taille, les vecteurs de couverture de cette taille et
+ * binaires, le masque ne contenir que 0, 1 ou 2, l'étape être comprise entre 1 et 7, le zéro primarisé
+ * désigner une case de la matrice et une étape 6 interrompue désigner une ligne de la matrice.
+ * 
+ * @param state L'état reconstruit.
+ * @param original La matrice originale.
+ * @return true si l'état peut être repris sans accès hors des bornes.
+ */
+bool is_valid_state(const HungarianState& state, const vector<vector<int>>& original)
+{
+    size_t sz = state.matrix.size();
+    if (sz == 0 || state.M.size() != sz || original.size() != sz)
+        return false;
+    for (size_t r = 0; r < sz; ++r) {
+        if (state.matrix[r].size() != sz || state.M[r].size() != sz || original[r].size() != sz)
+            return false;
+        for (int mark: state.M[r])
+            if (mark < 0 || mark > 2)
+                return false;
     }
+    if (state.RowCover.size() != sz || state.ColCover.size() != sz)
+        return false;
+    for (size_t i = 0; i < sz; ++i)
+        if ((state.RowCover[i] != 0 && state.RowCover[i] != 1) || (state.ColCover[i] != 0 && state.ColCover[i] != 1))
+            return false;
+    return state.step >= 1 && state.step <= 7
+        && state.path_row_0 >= 0 && state.path_row_0 < (int)sz
+        && state.path_col_0 >= 0 && state.path_col_0 < (int)sz
+        && state.augmentations >= 0
+        && state.step6_row >= 0 && state.step6_row < (int)sz
+        && (state.step6_row == 0 || state.step == 6);
+}
 
-    // Retourne la matrice générée
-    return matrix;
+
+/**
+ * @brief Reprend une résolution arrêtée par HungarianStart ou HungarianResume, sans repartir de l'étape 1.
+ * 
+ * @param state La liste renvoyée par l'appel précédent.
+ * @param time_limit_ms La durée maximale en millisecondes (0 pour aucune limite).
+ * @param verbose Indique si les étapes intermédiaires doivent être affichées (par défaut false).
+ * @return Une liste de même forme que celle de HungarianStart.
+ */
+// [[Rcpp::export]]
+List HungarianResume(List state, double time_limit_ms = 0, bool verbose = false)
+{
+    HungarianState resumed;
+    resumed.matrix = as<vector<vector<int>>>(state["matrix"]);
+    resumed.M = as<vector<vector<int>>>(state["M"]);
+    resumed.RowCover = as<vector<int>>(state["RowCover"]);
+    resumed.ColCover = as<vector<int>>(state["ColCover"]);
+    resumed.path_row_0 = as<int>(state["path_row_0"]);
+    resumed.path_col_0 = as<int>(state["path_col_0"]);
+    resumed.step = as<int>(state["step"]);
+    resumed.augmentations = as<int>(state["augmentations"]);
+    resumed.step6_row = as<int>(state["step6_row"]);
+    resumed.step6_min = as<int>(state["step6_min"]);
+    resumed.path.assign(2 * resumed.matrix.size() + 1, vector<int>(2, 0));
+    vector<vector<int>> original = as<vector<vector<int>>>(state["original"]);
+
+    if (!is_valid_state(resumed, original))
+        stop("Invalid solver state");
+    return run_resumable(resumed, original, time_limit_ms, verbose);
 }
 
-int main() {
-    vector<vector<int>> matrix_test = generateMatrix(6, 4);
-    print(matrix_test);
 
-    // Définir la matrice de coût
-    vector<vector<int>> matrix = generateMatrix(100, 10);
+/**
+ * @brief Convertit une liste d'associations (ligne -> colonne) en une matrice d'adjacence.
+ * 
+ * Les lignes sans association (valeur -1) restent entièrement nulles.
+ * 
+ * @param association La colonne associée à chaque ligne.
+ * @param cols Le nombre de colonnes de la matrice produite.
+ * @return La matrice d'adjacence (1 pour les couples associés, 0 sinon).
+ */
+vector<vector<int>> association_to_adjacency(const vector<int>& association, size_t cols)
+{
+    vector<vector<int>> adjacency(association.size(), vector<int>(cols, 0));
+    for (size_t row = 0; row < association.size(); ++row) {
+        if (association[row] >= 0) // Ignorer les lignes non associées
+            adjacency[row][association[row]] = 1;
+    }
+    return adjacency;
+}
 
-    // Nombre de fois à exécuter l'algorithme
-    int num_executions = 100;
-    
-    // Vecteur pour stocker les temps d'exécution
-    vector<double> execution_times(num_executions);
 
-    // Exécuter l'algorithme plusieurs fois et mesurer le temps d'exécution à chaque fois
-    for (int i = 0; i < num_executions; ++i) {
-        auto start = chrono::steady_clock::now();
-        Hungarian(matrix);
-        auto end = chrono::steady_clock::now();
-        chrono::duration<double, milli> duration = end - start;
-        execution_times[i] = duration.count();
+/**
+ * @brief Calcule une borne inférieure du coût optimal à partir des réductions de lignes et de colonnes de l'étape 1.
+ * 
+ * Pour une matrice carrée, la somme des minima de lignes puis des minima de colonnes de la matrice réduite est
+ * exactement ce que step1 soustrait. Pour une matrice rectangulaire, seule la réduction du plus petit côté
+ * reste valide (chaque ligne, ou chaque colonne, doit être associée).
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice de coûts originale (non ajustée).
+ * @return La borne inférieure.
+ */
+template<typename T>
+long long reduction_lower_bound(const vector<vector<T>>& matrix)
+{
+    size_t rows = matrix.size();
+    size_t cols = matrix[0].size();
+    long long bound = 0;
+
+    // Réduction des lignes : valable si chaque ligne doit être associée
+    vector<long long> row_min(rows, 0);
+    if (rows <= cols) {
+        for (size_t r = 0; r < rows; ++r) {
+            row_min[r] = *min_element(matrix[r].begin(), matrix[r].end());
+            bound += row_min[r];
+        }
     }
 
-    // Calculer la moyenne des temps d'exécution
-    double mean_execution_time = accumulate(execution_times.begin(), execution_times.end(), 0.0) / num_executions;
+    // Réduction des colonnes sur la matrice réduite : valable si chaque colonne doit être associée
+    if (cols <= rows) {
+        vector<long long> col_min(cols, numeric_limits<long long>::max());
+        for (size_t r = 0; r < rows; ++r) // Parcours par lignes pour rester contigu en mémoire
+            for (size_t c = 0; c < cols; ++c)
+                col_min[c] = min(col_min[c], (long long)matrix[r][c] - row_min[r]);
+        bound += accumulate(col_min.begin(), col_min.end(), 0LL);
+    }
 
-    // Calculer l'écart type
-    double variance = 0.0;
-    for (double time : execution_times) {
-        variance += pow(time - mean_execution_time, 2);
+    return bound;
+}
+
+
+/**
+ * @brief Calcule le coût d'une affectation en ignorant les cases fictives ajoutées par adjust_matrix.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice carrée ajustée.
+ * @param assignment La colonne associée à chaque ligne.
+ * @param rows Le nombre de lignes de la matrice originale.
+ * @param cols Le nombre de colonnes de la matrice originale.
+ * @return Le coût de l'affectation.
+ */
+template<typename T>
+long long assignment_cost(const vector<vector<T>>& matrix, const vector<int>& assignment, size_t rows, size_t cols)
+{
+    long long cost = 0;
+    for (size_t r = 0; r < rows; ++r) {
+        if ((size_t)assignment[r] < cols) // Les colonnes fictives ne comptent pas
+            cost += matrix[r][assignment[r]];
     }
-    variance /= num_executions;
-    double standard_deviation = sqrt(variance);
+    return cost;
+}
 
-    // Calculer l'intervalle de confiance à 95%
-    double confidence_interval = 1.96 * (standard_deviation / sqrt(num_executions));
 
-    // Afficher les résultats
-    cout << "Moyenne du temps d'execution : " << mean_execution_time << " millisecondes" << endl;
-    cout << "Intervalle de confiance (95%) : [" << mean_execution_time - confidence_interval
-              << ", " << mean_execution_time + confidence_interval << "] millisecondes" << endl;
+/**
+ * @brief Construit une affectation initiale gloutonne : chaque ligne prend la colonne libre la moins chère.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice carrée ajustée.
+ * @return La colonne associée à chaque ligne.
+ */
+template<typename T>
+vector<int> greedy_assignment(const vector<vector<T>>& matrix)
+{
+    int size = matrix.size();
+    vector<int> assignment(size, -1);
+    vector<bool> used(size, false);
+
+    for (int row = 0; row < size; ++row) {
+        int best = -1;
+        for (int col = 0; col < size; ++col) {
+            if (!used[col] && (best == -1 || matrix[row][col] < matrix[row][best]))
+                best = col; // Colonne libre la moins chère pour cette ligne
+        }
+        assignment[row] = best;
+        used[best] = true;
+    }
+    return assignment;
+}
+
+
+/**
+ * @brief Passe de recherche locale 2-opt : échange les colonnes de deux lignes si cela réduit le coût.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice carrée ajustée.
+ * @param assignment L'affectation courante (modifiée par référence).
+ * @param deadline L'instant limite au-delà duquel la passe s'interrompt.
+ * @return true si au moins un échange améliorant a été appliqué.
+ */
+template<typename T>
+bool local_search_2opt(const vector<vector<T>>& matrix, vector<int>& assignment, steady_clock::time_point deadline)
+{
+    int size = matrix.size();
+    bool improved = false;
+
+    for (int i = 0; i < size; ++i) {
+        if (steady_clock::now() >= deadline)
+            break; // Budget de temps épuisé
+        for (int k = i + 1; k < size; ++k) {
+            int a = assignment[i];
+            int b = assignment[k];
+            long long delta = (long long)matrix[i][b] + matrix[k][a] - matrix[i][a] - matrix[k][b];
+            if (delta < 0) { // L'échange réduit le coût
+                swap(assignment[i], assignment[k]);
+                improved = true;
+            }
+        }
+    }
+    return improved;
+}
+
+
+/**
+ * @brief Passe de recherche locale 3-opt : rotation des colonnes de trois lignes si cela réduit le coût.
+ * 
+ * Les lignes i, k et l prennent respectivement les colonnes de k, l et i. Cette passe n'est utilisée
+ * qu'une fois que 2-opt n'améliore plus la solution, car elle coûte O(n^3).
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice carrée ajustée.
+ * @param assignment L'affectation courante (modifiée par référence).
+ * @param deadline L'instant limite au-delà duquel la passe s'interrompt.
+ * @return true si au moins une rotation améliorante a été appliquée.
+ */
+template<typename T>
+bool local_search_3opt(const vector<vector<T>>& matrix, vector<int>& assignment, steady_clock::time_point deadline)
+{
+    int size = matrix.size();
+    bool improved = false;
+
+    for (int i = 0; i < size; ++i) {
+        for (int k = 0; k < size; ++k) {
+            if (steady_clock::now() >= deadline)
+                return improved; // Budget de temps épuisé : chaque k coûte déjà O(n)
+            if (k == i)
+                continue;
+            // Gain partiel si la ligne i prend la colonne de k
+            long long partial = (long long)matrix[i][assignment[k]] - matrix[i][assignment[i]] - matrix[k][assignment[k]];
+            for (int l = 0; l < size; ++l) {
+                if (l == i || l == k)
+                    continue;
+                int a = assignment[i];
+                int b = assignment[k];
+                int c = assignment[l];
+                long long delta = partial + matrix[k][c] + matrix[l][a] - matrix[l][c];
+                if (delta < 0) { // La rotation réduit le coût
+                    assignment[i] = b;
+                    assignment[k] = c;
+                    assignment[l] = a;
+                    improved = true;
+                    partial = (long long)matrix[i][assignment[k]] - matrix[i][assignment[i]] - matrix[k][assignment[k]];
+                }
+            }
+        }
+    }
+    return improved;
+}
+
+
+/**
+ * @brief Résout approximativement le problème d'association dans un budget de temps ou d'itérations.
+ * 
+ * Une affectation gloutonne est améliorée par recherche locale (2-opt puis 3-opt) jusqu'à ce qu'aucun
+ * échange n'améliore la solution ou que le budget soit épuisé. La meilleure solution trouvée est renvoyée
+ * avec la borne inférieure issue des réductions de l'étape 1, ce qui donne l'écart à l'optimum.
+ * Le budget couvre l'appel entier, mais il a un plancher : la borne inférieure, l'ajustement de la matrice,
+ * l'affectation gloutonne et la construction de la matrice d'affectation coûtent chacun O(n^2) et sont
+ * toujours exécutés. Un budget inférieur à ce plancher est donc dépassé, sans recherche locale. Une durée
+ * égale à celle de la passe gloutonne est réservée à la construction du résultat.
+ * 
+ * @param input La matrice d'entrée du problème.
+ * @param time_budget_ms Le budget de temps en millisecondes (0 pour aucune limite).
+ * @param max_iterations Le nombre maximal de passes de recherche locale (0 pour aucune limite).
+ * @param verbose Indique si les résultats doivent être affichés (par défaut false).
+ * @return Une liste contenant la matrice d'affectation, son coût, la borne inférieure, l'écart et la durée totale.
+ */
+// [[Rcpp::export]]
+List HungarianApprox(const vector<vector<int>>& input, double time_budget_ms = 100, int max_iterations = 0, bool verbose = false)
+{
+    auto start = steady_clock::now();
+    auto deadline = steady_clock::time_point::max();
+    if (time_budget_ms > 0)
+        deadline = start + duration_cast<steady_clock::duration>(duration<double, milli>(time_budget_ms));
+
+    size_t rows = input.size();
+    size_t cols = input[0].size();
+    long long lower_bound = reduction_lower_bound(input);
+
+    // Conversion en matrice carrée, sans copie lorsque l'entrée l'est déjà
+    vector<vector<int>> padded;
+    if (rows != cols) {
+        padded = input;
+        adjust_matrix(padded);
+    }
+    const vector<vector<int>>& matrix = rows != cols ? padded : input;
+
+    auto greedy_start = steady_clock::now();
+    vector<int> assignment = greedy_assignment(matrix);
+    auto search_deadline = deadline;
+    if (time_budget_ms > 0) // Réserver la construction du résultat, de coût comparable à la passe gloutonne
+        search_deadline -= steady_clock::now() - greedy_start;
+
+    // Recherche locale seulement s'il reste du budget après l'affectation gloutonne
+    int iterations = 0;
+    bool improved = true;
+    while (improved && (max_iterations <= 0 || iterations < max_iterations) && steady_clock::now() < search_deadline) {
+        improved = local_search_2opt(matrix, assignment, search_deadline);
+        if (!improved) // 3-opt seulement lorsque 2-opt a atteint un optimum local
+            improved = local_search_3opt(matrix, assignment, search_deadline);
+        iterations++;
+    }
+
+    long long cost = assignment_cost(matrix, assignment, rows, cols);
+    long long gap = cost - lower_bound;
+    vector<vector<int>> adjacency = association_to_adjacency(assignment, matrix.size());
+    auto end = steady_clock::now();
+    double elapsed_ms = duration<double, milli>(end - start).count(); // Durée de l'appel entier
+    bool budget_exhausted = improved || end >= deadline;
+
+    if (verbose) {
+        print("Assignment : ");
+        print(assignment);
+        print("Cost : ", cost);
+        print("Lower bound : ", lower_bound);
+        print("Gap : ", gap);
+        print("Iterations : ", iterations);
+        print("Elapsed (ms) : ", elapsed_ms);
+    }
+
+    return List::create(
+        Named("assignment") = adjacency,
+        Named("cost") = (double)cost,
+        Named("lower_bound") = (double)lower_bound,
+        Named("gap") = (double)gap,
+        Named("relative_gap") = cost != 0 ? (double)gap / fabs((double)cost) : 0.0,
+        Named("iterations") = iterations,
+        Named("budget_exhausted") = budget_exhausted,
+        Named("elapsed_ms") = elapsed_ms
+    );
+}
+
+
+/**
+ * @brief Structure union-find (ensembles disjoints) avec compression de chemin et union par rang.
+ */
+struct DisjointSet {
+    vector<int> parent; // Parent de chaque élément
+    vector<int> rank;   // Rang (borne de hauteur) de chaque racine
+
+    DisjointSet(int size) : parent(size), rank(size, 0) {
+        iota(parent.begin(), parent.end(), 0); // Chaque élément est initialement sa propre racine
+    }
+
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]]; // Compression de chemin par division
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+            return;
+        if (rank[a] < rank[b])
+            swap(a, b);
+        parent[b] = a; // Rattacher l'arbre le moins haut sous l'autre
+        if (rank[a] == rank[b])
+            rank[a]++;
+    }
+};
+
+
+/**
+ * @brief Sous-problème indépendant : les lignes et colonnes d'une composante connexe du graphe des associations autorisées.
+ */
+struct Component {
+    vector<int> rows; // Indices des lignes dans la matrice originale
+    vector<int> cols; // Indices des colonnes dans la matrice originale
+};
+
+
+/**
+ * @brief Découpe le graphe biparti des associations autorisées en composantes connexes.
+ * 
+ * Les lignes sont les sommets 0..n-1 et les colonnes les sommets n..n+m-1. Deux sommets sont reliés si
+ * l'association correspondante n'est pas interdite. Les lignes ou colonnes isolées ne forment pas de
+ * sous-problème puisqu'elles ne peuvent être associées à rien.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice de coûts originale.
+ * @return Les composantes contenant au moins une ligne et une colonne, de la plus grande à la plus petite.
+ */
+template<typename T>
+vector<Component> find_components(const vector<vector<T>>& matrix)
+{
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+    DisjointSet sets(rows + cols);
+
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            if (!is_forbidden(matrix[r][c]))
+                sets.unite(r, rows + c); // Relier la ligne et la colonne
+        }
+    }
+
+    // Regrouper les lignes et colonnes par racine
+    vector<int> component_of(rows + cols, -1);
+    vector<Component> components;
+    for (int v = 0; v < rows + cols; ++v) {
+        int root = sets.find(v);
+        if (component_of[root] == -1) {
+            component_of[root] = components.size();
+            components.push_back(Component());
+        }
+        if (v < rows)
+            components[component_of[root]].rows.push_back(v);
+        else
+            components[component_of[root]].cols.push_back(v - rows);
+    }
+
+    // Écarter les sommets isolés
+    components.erase(remove_if(components.begin(), components.end(), [](const Component& component) {
+        return component.rows.empty() || component.cols.empty();
+    }), components.end());
+
+    // Les plus gros sous-problèmes d'abord pour équilibrer la charge entre les threads
+    sort(components.begin(), components.end(), [](const Component& a, const Component& b) {
+        return max(a.rows.size(), a.cols.size()) > max(b.rows.size(), b.cols.size());
+    });
+
+    return components;
+}
+
+
+/**
+ * @brief Résout le sous-problème d'une composante et écrit ses associations dans la matrice d'affectation globale.
+ * 
+ * Les associations interdites sont remplacées par un coût de pénalité supérieur à toute affectation autorisée
+ * de la composante, ce qui évite les débordements dans step6 ; elles sont ignorées dans le résultat. Si cette
+ * pénalité ne tient pas sous INT_MAX / 4, la composante n'est pas résolue (une pénalité plafonnée pourrait
+ * faire préférer une association interdite).
+ * 
+ * @param matrix La matrice de coûts originale.
+ * @param component La composante à résoudre.
+ * @param assignment La matrice d'affectation globale (modifiée par référence, lignes disjointes entre composantes).
+ * @return false si les coûts de la composante sont trop grands pour une pénalité sûre, sinon true.
+ */
+bool solve_component(const vector<vector<int>>& matrix, const Component& component, vector<vector<int>>& assignment)
+{
+    size_t rows = component.rows.size();
+    size_t cols = component.cols.size();
+
+    // Pénalité plus grande que la somme des coûts autorisés maximaux de la composante
+    long long max_allowed = 0;
+    bool has_forbidden = false;
+    for (int r: component.rows) {
+        for (int c: component.cols) {
+            if (is_forbidden(matrix[r][c]))
+                has_forbidden = true;
+            else
+                max_allowed = max(max_allowed, (long long)matrix[r][c]);
+        }
+    }
+    long long penalty = (max_allowed + 1) * (long long)max(rows, cols) + 1;
+    if (has_forbidden && penalty > (long long)numeric_limits<int>::max() / 4)
+        return false;
+
+    // Extraire la sous-matrice de la composante
+    vector<vector<int>> sub_matrix(rows, vector<int>(cols));
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            int value = matrix[component.rows[r]][component.cols[c]];
+            sub_matrix[r][c] = is_forbidden(value) ? (int)penalty : value;
+        }
+    }
+
+    vector<vector<int>> M = Hungarian(sub_matrix, false);
+
+    // Reporter les associations dans l'indexation originale
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            int row = component.rows[r];
+            int col = component.cols[c];
+            if (M[r][c] == 1 && !is_forbidden(matrix[row][col]))
+                assignment[row][col] = 1;
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Vérifie que la matrice d'affectation associe toutes les lignes (ou toutes les colonnes si elles sont moins nombreuses).
+ * 
+ * @param assignment La matrice d'affectation.
+ * @return true si l'affectation est complète, sinon false.
+ */
+bool is_complete_assignment(const vector<vector<int>>& assignment)
+{
+    size_t matched = 0;
+    for (const auto& row: assignment)
+        matched += count(row.begin(), row.end(), 1);
+    return matched == min(assignment.size(), assignment[0].size());
+}
+
+
+/**
+ * @brief Résout le problème d'association en le découpant en composantes indépendantes résolues en parallèle.
+ * 
+ * Les associations interdites sont codées par la valeur maximale d'un entier. Lorsque le graphe des associations
+ * autorisées est déconnecté, chaque composante est résolue séparément par Hungarian, ce qui ramène le coût
+ * de O(n^3) à la somme des cubes des tailles des composantes. Les composantes sont réparties entre plusieurs threads.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param threads Le nombre de threads à utiliser (0 pour le nombre de coeurs disponibles).
+ * @param verbose Indique si les composantes trouvées doivent être affichées (par défaut false).
+ * @return La matrice d'affectation de même dimension que la matrice d'entrée.
+ */
+// [[Rcpp::export]]
+vector<vector<int>> HungarianBlocks(const vector<vector<int>>& matrix, int threads = 0, bool verbose = false)
+{
+    vector<Component> components = find_components(matrix);
+    vector<vector<int>> assignment(matrix.size(), vector<int>(matrix[0].size(), 0));
+
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+    threads = min(threads, (int)components.size());
+
+    if (verbose) {
+        print("Components : ", components.size());
+        for (const auto& component: components)
+            cout << component.rows.size() << " x " << component.cols.size() << endl;
+        print("Threads : ", threads);
+    }
+
+    // Chaque thread prend la prochaine composante non traitée
+    atomic<size_t> next_component(0);
+    atomic<bool> costs_too_large(false);
+    auto worker = [&]() {
+        for (size_t index = next_component++; index < components.size(); index = next_component++)
+            if (!solve_component(matrix, components[index], assignment))
+                costs_too_large = true;
+    };
+
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker(); // Le thread appelant participe aussi
+    for (auto& t: pool)
+        t.join();
+
+    // Les erreurs sont signalées depuis le thread appelant, après la fin des threads
+    if (costs_too_large)
+        stop("Costs are too large to exclude forbidden entries safely");
+    if (!is_complete_assignment(assignment))
+        stop("No complete assignment exists with the allowed entries");
+
+    if (verbose) {
+        print("Assignments Matrix:");
+        print(assignment);
+    }
+
+    return assignment;
+}
+
+
+/**
+ * @brief Fixe les associations forcées avant la résolution et renvoie le sous-problème résiduel.
+ * 
+ * Une ligne qui doit être associée (au plus autant de lignes que de colonnes) et qui n'a plus qu'une seule
+ * colonne autorisée est forcément associée à cette colonne, dans toute solution réalisable. La ligne et la
+ * colonne sont retirées, ce qui peut réduire le degré d'autres lignes ou colonnes : le processus est répété
+ * jusqu'à un point fixe. La règle symétrique s'applique aux colonnes.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice de coûts originale.
+ * @param assignment La matrice d'affectation, où sont écrites les associations forcées (modifiée par référence).
+ * @param forced Le nombre d'associations forcées (mis à jour par référence).
+ * @return Les lignes et colonnes restantes, à résoudre par l'algorithme hongrois.
+ */
+template<typename T>
+Component presolve_forced(const vector<vector<T>>& matrix, vector<vector<int>>& assignment, int& forced)
+{
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+    bool force_rows = rows <= cols; // Chaque ligne doit être associée
+    bool force_cols = cols <= rows; // Chaque colonne doit être associée
+
+    // Degré de chaque ligne et colonne dans le graphe des associations autorisées
+    vector<int> row_degree(rows, 0);
+    vector<int> col_degree(cols, 0);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            if (!is_forbidden(matrix[r][c])) {
+                row_degree[r]++;
+                col_degree[c]++;
+            }
+        }
+    }
+
+    vector<bool> row_active(rows, true);
+    vector<bool> col_active(cols, true);
+    vector<int> pending; // Sommets de degré 1 : lignes 0..rows-1, colonnes rows..rows+cols-1
+    for (int r = 0; r < rows && force_rows; ++r)
+        if (row_degree[r] == 1)
+            pending.push_back(r);
+    for (int c = 0; c < cols && force_cols; ++c)
+        if (col_degree[c] == 1)
+            pending.push_back(rows + c);
+
+    forced = 0;
+    while (!pending.empty()) {
+        int vertex = pending.back();
+        pending.pop_back();
+
+        // Retrouver l'unique voisin actif du sommet
+        int row = -1;
+        int col = -1;
+        if (vertex < rows) {
+            row = vertex;
+            if (!row_active[row] || row_degree[row] != 1)
+                continue; // Déjà fixé ou degré modifié entre-temps
+            for (int c = 0; c < cols && col == -1; ++c)
+                if (col_active[c] && !is_forbidden(matrix[row][c]))
+                    col = c;
+        }
+        else {
+            col = vertex - rows;
+            if (!col_active[col] || col_degree[col] != 1)
+                continue; // Déjà fixé ou degré modifié entre-temps
+            for (int r = 0; r < rows && row == -1; ++r)
+                if (row_active[r] && !is_forbidden(matrix[r][col]))
+                    row = r;
+        }
+
+        // Fixer l'association et retirer la ligne et la colonne
+        assignment[row][col] = 1;
+        row_active[row] = false;
+        col_active[col] = false;
+        forced++;
+
+        // Mettre à jour les degrés des voisins restants
+        for (int r = 0; r < rows; ++r) {
+            if (row_active[r] && !is_forbidden(matrix[r][col])) {
+                if (--row_degree[r] == 1 && force_rows)
+                    pending.push_back(r);
+            }
+        }
+        for (int c = 0; c < cols; ++c) {
+            if (col_active[c] && !is_forbidden(matrix[row][c])) {
+                if (--col_degree[c] == 1 && force_cols)
+                    pending.push_back(rows + c);
+            }
+        }
+    }
+
+    // Sous-problème résiduel
+    Component residual;
+    for (int r = 0; r < rows; ++r)
+        if (row_active[r])
+            residual.rows.push_back(r);
+    for (int c = 0; c < cols; ++c)
+        if (col_active[c])
+            residual.cols.push_back(c);
+    return residual;
+}
+
+
+/**
+ * @brief Résout le problème d'association après une étape de présolution qui fixe les associations forcées.
+ * 
+ * Les associations interdites sont codées par la valeur maximale d'un entier. Les associations forcées sont
+ * fixées jusqu'à un point fixe, puis seul le problème résiduel est résolu par Hungarian et ses associations
+ * sont reportées dans l'indexation originale.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si la réduction obtenue doit être affichée (par défaut false).
+ * @return Une liste contenant la matrice d'affectation, le nombre d'associations forcées, la taille du
+ * problème résiduel et la fraction de cases éliminées.
+ */
+// [[Rcpp::export]]
+List HungarianPresolve(const vector<vector<int>>& matrix, bool verbose = false)
+{
+    vector<vector<int>> assignment(matrix.size(), vector<int>(matrix[0].size(), 0));
+    int forced = 0;
+    Component residual = presolve_forced(matrix, assignment, forced);
+
+    // Résoudre le problème résiduel s'il en reste un
+    if (!residual.rows.empty() && !residual.cols.empty() && !solve_component(matrix, residual, assignment))
+        stop("Costs are too large to exclude forbidden entries safely");
+    if (!is_complete_assignment(assignment))
+        stop("No complete assignment exists with the allowed entries");
+
+    double original_cells = (double)matrix.size() * matrix[0].size();
+    double residual_cells = (double)residual.rows.size() * residual.cols.size();
+    double reduction = 1.0 - residual_cells / original_cells;
+
+    if (verbose) {
+        print("Forced assignments : ", forced);
+        cout << "Residual problem : " << residual.rows.size() << " x " << residual.cols.size() << endl;
+        print("Reduction : ", reduction);
+        print("Assignments Matrix:");
+        print(assignment);
+    }
+
+    return List::create(
+        Named("assignment") = assignment,
+        Named("forced") = forced,
+        Named("residual_rows") = (int)residual.rows.size(),
+        Named("residual_cols") = (int)residual.cols.size(),
+        Named("reduction") = reduction
+    );
+}
+
+
+/**
+ * @brief Division entière arrondie vers moins l'infini.
+ */
+inline long long floor_div(long long a, long long b)
+{
+    return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+
+/**
+ * @brief Vérifie que l'écart des coûts permet la mise à l'échelle sans débordement des entiers 64 bits.
+ * 
+ * Les coûts sont multipliés par (n + 1) et les prix peuvent croître jusqu'à quelques n fois le plus grand coût
+ * mis à l'échelle : l'écart doit donc rester sous LLONG_MAX / (4 (n + 1)^2).
+ * 
+ * @param min_cost Le plus petit coût.
+ * @param max_cost Le plus grand coût.
+ * @param size Le nombre de lignes (et de colonnes) du problème carré.
+ * @return true si la mise à l'échelle est sûre, sinon false.
+ */
+inline bool cost_range_fits(long double min_cost, long double max_cost, long long size)
+{
+    long double limit = (long double)numeric_limits<long long>::max() / (4.0L * (size + 1) * (size + 1));
+    return max_cost - min_cost <= limit;
+}
+
+
+/**
+ * @brief Problème d'affectation creux au format compressé par lignes, résolu par mise à l'échelle des coûts.
+ * 
+ * Les lignes sont les agents et les colonnes les objets, en nombre égal. Les arcs de la ligne r occupent
+ * les positions start[r]..end[r]-1 : la fixation d'arcs les retire en réduisant end[r].
+ * 
+ * @tparam T Le type entier des coûts (int ou int64_t).
+ */
+template<typename T>
+struct CostScalingSolver {
+    static_assert(is_integral<T>::value, "Cost scaling requires integer costs");
+
+    int size;                   // Nombre de lignes et de colonnes
+    vector<int> start;          // Début des arcs de chaque ligne
+    vector<int> end;            // Fin des arcs encore actifs de chaque ligne
+    vector<int> arc_col;        // Colonne de chaque arc
+    vector<long long> arc_cost; // Coût de chaque arc multiplié par (size + 1)
+    vector<long long> price;    // Prix de chaque colonne
+    vector<int> owner;          // Ligne associée à chaque colonne, ou -1
+    vector<int> assigned;       // Colonne associée à chaque ligne, ou -1
+    vector<int> assigned_arc;   // Arc utilisé par chaque ligne associée
+    vector<int> arc_row;        // Ligne de chaque arc
+    long long max_cost = 0;     // Plus grand coût mis à l'échelle
+    long long bids = 0;         // Nombre total d'enchères (statistique)
+    int global_updates = 0;     // Nombre de mises à jour globales des prix (statistique)
+    int fixed_arcs = 0;         // Nombre d'arcs fixés (statistique)
+    CancellationToken* token = nullptr; // Jeton d'annulation optionnel
+
+    /**
+     * @brief Construit le solveur à partir d'une matrice creuse ; les coûts sont translatés pour être positifs.
+     */
+    CostScalingSolver(int n, const vector<int>& row_start, const vector<int>& cols, const vector<T>& costs)
+        : size(n), start(row_start), end(row_start.begin() + 1, row_start.end()), arc_col(cols),
+          arc_cost(costs.size()), price(n, 0), owner(n, -1), assigned(n, -1), assigned_arc(n, -1), arc_row(costs.size())
+    {
+        for (int r = 0; r < size; ++r)
+            for (int a = start[r]; a < start[r + 1]; ++a)
+                arc_row[a] = r;
+        T min_cost = costs.empty() ? 0 : *min_element(costs.begin(), costs.end());
+        for (size_t a = 0; a < costs.size(); ++a) {
+            arc_cost[a] = ((long long)costs[a] - min_cost) * (size + 1);
+            max_cost = max(max_cost, arc_cost[a]);
+        }
+    }
+
+    /**
+     * @brief Retire les arcs dont le coût réduit dépasse 2Nε : ils ne peuvent appartenir à aucune solution optimale.
+     */
+    void fix_arcs(long long epsilon)
+    {
+        long long threshold = 2LL * (2 * size) * epsilon;
+        for (int r = 0; r < size; ++r) {
+            long long best = numeric_limits<long long>::max();
+            for (int a = start[r]; a < end[r]; ++a)
+                best = min(best, arc_cost[a] + price[arc_col[a]]);
+            for (int a = start[r]; a < end[r];) {
+                if (arc_cost[a] + price[arc_col[a]] - best > threshold) {
+                    // Échanger l'arc avec le dernier arc actif de la ligne
+                    end[r]--;
+                    swap(arc_col[a], arc_col[end[r]]);
+                    swap(arc_cost[a], arc_cost[end[r]]);
+                    fixed_arcs++;
+                }
+                else {
+                    a++;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Mise à jour globale des prix : chaque colonne est renchérie de ε fois sa distance à une colonne libre.
+     * 
+     * Les distances sont calculées par Dijkstra depuis les colonnes libres dans le graphe résiduel, avec des longueurs
+     * d'arc entières floor(coût réduit / ε) + 1, ce qui préserve la ε-optimalité tout en orientant les enchères
+     * suivantes vers les colonnes libres.
+     */
+    void global_price_update(long long epsilon, const vector<int>& reverse_start, const vector<int>& reverse_arc)
+    {
+        const long long unreached = numeric_limits<long long>::max();
+        vector<long long> dist(size, unreached);
+        vector<bool> done(size, false);
+        priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> heap;
+        for (int c = 0; c < size; ++c) {
+            if (owner[c] == -1) {
+                dist[c] = 0;
+                heap.push(make_pair(0, c));
+            }
+        }
+
+        long long max_dist = 0;
+        while (!heap.empty()) {
+            int c = heap.top().second;
+            heap.pop();
+            if (done[c])
+                continue;
+            done[c] = true;
+            max_dist = max(max_dist, dist[c]);
+
+            // Les lignes pouvant prendre la colonne c libèrent leur colonne actuelle
+            for (int k = reverse_start[c]; k < reverse_start[c + 1]; ++k) {
+                int a = reverse_arc[k];
+                int r = arc_row[a];
+                if (assigned[r] == -1 || assigned[r] == c)
+                    continue;
+                int current = assigned[r];
+                long long slack = arc_cost[a] + price[c] - arc_cost[assigned_arc[r]] - price[current];
+                long long length = floor_div(slack, epsilon) + 1;
+                if (dist[c] + length < dist[current]) {
+                    dist[current] = dist[c] + length;
+                    heap.push(make_pair(dist[current], current));
+                }
+            }
+        }
+
+        for (int c = 0; c < size; ++c)
+            price[c] += epsilon * (done[c] ? dist[c] : max_dist + 1);
+        global_updates++;
+    }
+
+    /**
+     * @brief Phase de raffinement : part d'une affectation vide et produit une affectation complète ε-optimale.
+     */
+    void refine(long long epsilon)
+    {
+        fill(owner.begin(), owner.end(), -1);
+        fill(assigned.begin(), assigned.end(), -1);
+
+        // Index inverse des arcs actifs par colonne pour les mises à jour globales
+        vector<int> reverse_start(size + 1, 0);
+        for (int r = 0; r < size; ++r)
+            for (int a = start[r]; a < end[r]; ++a)
+                reverse_start[arc_col[a] + 1]++;
+        partial_sum(reverse_start.begin(), reverse_start.end(), reverse_start.begin());
+        vector<int> reverse_arc(reverse_start[size]);
+        vector<int> fill_position(reverse_start.begin(), reverse_start.end() - 1);
+        for (int r = 0; r < size; ++r)
+            for (int a = start[r]; a < end[r]; ++a)
+                reverse_arc[fill_position[arc_col[a]]++] = a;
+
+        vector<int> free_rows(size);
+        iota(free_rows.begin(), free_rows.end(), 0);
+        long long bids_since_update = 0;
+
+        while (!free_rows.empty()) {
+            if (token && token->should_stop())
+                return; // Résolution abandonnée
+            int r = free_rows.back();
+            free_rows.pop_back();
+
+            // Meilleure et deuxième meilleure colonne pour la ligne r
+            int best_arc = -1;
+            long long best = numeric_limits<long long>::max();
+            long long second = numeric_limits<long long>::max();
+            for (int a = start[r]; a < end[r]; ++a) {
+                long long value = arc_cost[a] + price[arc_col[a]];
+                if (value < best) {
+                    second = best;
+                    best = value;
+                    best_arc = a;
+                }
+                else if (value < second) {
+                    second = value;
+                }
+            }
+            if (second == numeric_limits<long long>::max())
+                second = best + (long long)size * epsilon; // Un seul arc : toute hausse de prix reste ε-optimale
+
+            // Double poussée : prendre la colonne et relever son prix jusqu'à la deuxième meilleure valeur
+            int best_col = arc_col[best_arc];
+            price[best_col] += second - best + epsilon;
+            if (owner[best_col] != -1) {
+                assigned[owner[best_col]] = -1;
+                free_rows.push_back(owner[best_col]);
+            }
+            owner[best_col] = r;
+            assigned[r] = best_col;
+            assigned_arc[r] = best_arc;
+            bids++;
+
+            if (++bids_since_update >= size && !free_rows.empty()) {
+                global_price_update(epsilon, reverse_start, reverse_arc);
+                bids_since_update = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Résout le problème par phases de ε décroissant ; avec ε = 1 sur les coûts multipliés par (n + 1),
+     * l'affectation est optimale.
+     */
+    void solve(long long alpha = 8)
+    {
+        long long epsilon = max(1LL, max_cost);
+        do {
+            long long previous = epsilon;
+            epsilon = max(1LL, epsilon / alpha);
+            if (bids > 0)
+                fix_arcs(previous);
+            refine(epsilon);
+        } while (epsilon > 1 && !(token && token->cancelled));
+    }
+};
+
+
+/**
+ * @brief Résout un problème d'affectation creux par mise à l'échelle des coûts (Goldberg–Kennedy).
+ * 
+ * Les lignes excédentaires par rapport aux colonnes ne sont pas acceptées ; lorsque les colonnes sont plus
+ * nombreuses, des lignes fictives de coût nul reliées à toutes les colonnes sont ajoutées.
+ * 
+ * @tparam T Le type entier des coûts (int ou int64_t).
+ * @param rows Le nombre de lignes.
+ * @param cols Le nombre de colonnes.
+ * @param arc_rows La ligne de chaque arc (indices à partir de 0).
+ * @param arc_cols La colonne de chaque arc (indices à partir de 0).
+ * @param arc_costs Le coût de chaque arc.
+ * @param assignment La colonne associée à chaque ligne (mis à jour par référence).
+ * @param verbose Indique si les statistiques de résolution doivent être affichées.
+ * @param token Le jeton d'annulation optionnel.
+ * @return false si aucune affectation complète des lignes n'existe, si l'écart des coûts est trop grand
+ * (voir cost_range_fits) ou si la résolution a été annulée, sinon true.
+ */
+template<typename T>
+bool cost_scaling_assignment(int rows, int cols, const vector<int>& arc_rows, const vector<int>& arc_cols, const vector<T>& arc_costs, vector<int>& assignment, bool verbose = false, CancellationToken* token = nullptr)
+{
+    if (rows > cols)
+        return false;
+    int size = cols;
+
+    // Les lignes fictives ajoutent des arcs de coût nul
+    long double min_cost = rows < cols ? 0 : numeric_limits<long double>::max();
+    long double max_cost = rows < cols ? 0 : numeric_limits<long double>::lowest();
+    for (T cost: arc_costs) {
+        min_cost = min(min_cost, (long double)cost);
+        max_cost = max(max_cost, (long double)cost);
+    }
+    if (!arc_costs.empty() && !cost_range_fits(min_cost, max_cost, size))
+        return false;
+
+    // Construction du format compressé par lignes, avec les lignes fictives
+    vector<int> start(size + 1, 0);
+    for (int r: arc_rows)
+        start[r + 1]++;
+    for (int r = rows; r < size; ++r)
+        start[r + 1] = cols;
+    partial_sum(start.begin(), start.end(), start.begin());
+    vector<int> adj(start[size]);
+    vector<T> costs(start[size], 0);
+    vector<int> position(start.begin(), start.end() - 1);
+    for (size_t a = 0; a < arc_rows.size(); ++a) {
+        adj[position[arc_rows[a]]] = arc_cols[a];
+        costs[position[arc_rows[a]]++] = arc_costs[a];
+    }
+    for (int r = rows; r < size; ++r)
+        for (int c = 0; c < cols; ++c)
+            adj[position[r]++] = c;
+
+    // Vérifier qu'une affectation complète existe avant de lancer les enchères
+    vector<int> match_row(size, -1);
+    vector<int> match_col(size, -1);
+    if (hopcroft_karp(start, adj, match_row, match_col) < size)
+        return false;
+
+    CostScalingSolver<T> solver(size, start, adj, costs);
+    solver.token = token;
+    solver.solve();
+    if (token && token->cancelled)
+        return false;
+
+    assignment.assign(solver.assigned.begin(), solver.assigned.begin() + rows);
+    if (verbose) {
+        print("Bids : ", solver.bids);
+        print("Global price updates : ", solver.global_updates);
+        print("Fixed arcs : ", solver.fixed_arcs);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Résout une matrice de coûts dense par mise à l'échelle des coûts.
+ * 
+ * Les associations interdites (valeur maximale d'un entier) ne sont pas des arcs du problème. Si la matrice
+ * a plus de lignes que de colonnes, le problème transposé est résolu.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param result La matrice d'affectation de même dimension que la matrice d'entrée (mise à jour par référence).
+ * @param verbose Indique si les statistiques de résolution doivent être affichées.
+ * @param token Le jeton d'annulation optionnel.
+ * @return false si aucune affectation complète n'existe ou si la résolution a été annulée, sinon true.
+ */
+bool cost_scaling_dense(const vector<vector<int>>& matrix, vector<vector<int>>& result, bool verbose = false, CancellationToken* token = nullptr)
+{
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+    bool transposed = rows > cols;
+
+    vector<int> arc_rows;
+    vector<int> arc_cols;
+    vector<int> arc_costs;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            if (!is_forbidden(matrix[r][c])) {
+                arc_rows.push_back(transposed ? c : r);
+                arc_cols.push_back(transposed ? r : c);
+                arc_costs.push_back(matrix[r][c]);
+            }
+        }
+    }
+
+    vector<int> assignment;
+    if (!cost_scaling_assignment(min(rows, cols), max(rows, cols), arc_rows, arc_cols, arc_costs, assignment, verbose, token))
+        return false;
+
+    result.assign(rows, vector<int>(cols, 0));
+    for (size_t i = 0; i < assignment.size(); ++i) {
+        if (transposed)
+            result[assignment[i]][i] = 1;
+        else
+            result[i][assignment[i]] = 1;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Implémente l'algorithme de mise à l'échelle des coûts pour une matrice de coûts entiers dense.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si les statistiques de résolution doivent être affichées (par défaut false).
+ * @return La matrice d'affectation de même dimension que la matrice d'entrée.
+ */
+// [[Rcpp::export]]
+vector<vector<int>> HungarianCostScaling(const vector<vector<int>>& matrix, bool verbose = false)
+{
+    // Même contrôle que cost_scaling_assignment, les lignes fictives (coût nul) n'existant que si la matrice est rectangulaire
+    bool square = matrix.size() == matrix[0].size();
+    long double min_cost = square ? numeric_limits<long double>::max() : 0;
+    long double max_cost = square ? numeric_limits<long double>::lowest() : 0;
+    for (const auto& row: matrix) {
+        for (int element: row) {
+            if (!is_forbidden(element)) {
+                min_cost = min(min_cost, (long double)element);
+                max_cost = max(max_cost, (long double)element);
+            }
+        }
+    }
+    if (min_cost <= max_cost && !cost_range_fits(min_cost, max_cost, max(matrix.size(), matrix[0].size())))
+        stop("Cost range is too large for cost scaling");
+
+    vector<vector<int>> result;
+    if (!cost_scaling_dense(matrix, result, verbose))
+        stop("No complete assignment exists with the allowed entries");
+
+    if (verbose) {
+        print("Assignments Matrix:");
+        print(result);
+    }
+    return result;
+}
+
+
+/**
+ * @brief Résout un problème creux donné par triplets aux indices R, pour des coûts entiers de type T.
+ * 
+ * @tparam T Le type entier des coûts (int ou int64_t).
+ */
+template<typename T>
+vector<int> sparse_cost_scaling(vector<int> rows, vector<int> cols, const vector<T>& costs, int nrow, int ncol, bool verbose)
+{
+    if (rows.size() != cols.size() || rows.size() != costs.size())
+        stop("rows, cols and costs must have the same length");
+    for (size_t a = 0; a < rows.size(); ++a) {
+        if (rows[a] < 1 || rows[a] > nrow || cols[a] < 1 || cols[a] > ncol)
+            stop("Arc index out of range");
+        rows[a]--; // Passage aux indices à partir de 0
+        cols[a]--;
+    }
+    if (!costs.empty()) {
+        auto bounds = minmax_element(costs.begin(), costs.end());
+        if (!cost_range_fits(min((long double)*bounds.first, 0.0L), max((long double)*bounds.second, 0.0L), ncol))
+            stop("Cost range is too large for cost scaling");
+    }
+
+    vector<int> assignment;
+    if (!cost_scaling_assignment(nrow, ncol, rows, cols, costs, assignment, verbose))
+        stop("No complete assignment of the rows exists");
+
+    for (auto& col: assignment)
+        col++; // Retour aux indices R
+    return assignment;
+}
+
+
+/**
+ * @brief Implémente l'algorithme de mise à l'échelle des coûts pour une matrice creuse donnée par triplets.
+ * 
+ * @param rows La ligne de chaque arc (indices R à partir de 1).
+ * @param cols La colonne de chaque arc (indices R à partir de 1).
+ * @param costs Le coût de chaque arc.
+ * @param nrow Le nombre de lignes (au plus ncol).
+ * @param ncol Le nombre de colonnes.
+ * @param verbose Indique si les statistiques de résolution doivent être affichées (par défaut false).
+ * @return La colonne (à partir de 1) associée à chaque ligne.
+ */
+// [[Rcpp::export]]
+vector<int> HungarianCostScalingSparse(vector<int> rows, vector<int> cols, const vector<int>& costs, int nrow, int ncol, bool verbose = false)
+{
+    return sparse_cost_scaling(rows, cols, costs, nrow, ncol, verbose);
+}
+
+
+/**
+ * @brief Variante 64 bits de HungarianCostScalingSparse pour des coûts entiers hors de la plage des entiers R.
+ * 
+ * R n'ayant pas d'entier 64 bits natif, les coûts sont passés en numérique : chacun doit être entier et
+ * représentable exactement (valeur absolue au plus 2^53).
+ * 
+ * @param rows La ligne de chaque arc (indices R à partir de 1).
+ * @param cols La colonne de chaque arc (indices R à partir de 1).
+ * @param costs Le coût entier de chaque arc.
+ * @param nrow Le nombre de lignes (au plus ncol).
+ * @param ncol Le nombre de colonnes.
+ * @param verbose Indique si les statistiques de résolution doivent être affichées (par défaut false).
+ * @return La colonne (à partir de 1) associée à chaque ligne.
+ */
+// [[Rcpp::export]]
+vector<int> HungarianCostScalingSparse64(vector<int> rows, vector<int> cols, const vector<double>& costs, int nrow, int ncol, bool verbose = false)
+{
+    const double exact_limit = 9007199254740992.0; // 2^53
+    vector<int64_t> integer_costs(costs.size());
+    for (size_t a = 0; a < costs.size(); ++a) {
+        if (!(fabs(costs[a]) <= exact_limit) || costs[a] != floor(costs[a]))
+            stop("costs must be integers of absolute value at most 2^53");
+        integer_costs[a] = (int64_t)costs[a];
+    }
+    return sparse_cost_scaling(rows, cols, integer_costs, nrow, ncol, verbose);
+}
+
+
+/**
+ * @brief Résout le problème d'association goulot : minimiser le plus grand coût d'une association.
+ * 
+ * Les coûts autorisés distincts sont triés une fois, puis le seuil est cherché par dichotomie. Pour chaque seuil,
+ * un couplage maximal de Hopcroft–Karp est calculé sur les associations de coût inférieur ou égal au seuil, en
+ * repartant du couplage du seuil précédent privé des associations devenues trop chères. Les colonnes de chaque
+ * ligne étant triées par coût, le graphe d'un seuil est un préfixe de chaque ligne.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si le seuil et l'affectation doivent être affichés (par défaut false).
+ * @return Une liste contenant la matrice d'affectation et la valeur du goulot.
+ */
+// [[Rcpp::export]]
+List HungarianBottleneck(const vector<vector<int>>& matrix, bool verbose = false)
+{
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+    bool transposed = rows > cols; // Les lignes du couplage doivent être le plus petit côté
+    int left = min(rows, cols);
+    int right = max(rows, cols);
+    auto cost = [&](int l, int r) { return transposed ? matrix[r][l] : matrix[l][r]; };
+
+    // Colonnes autorisées de chaque ligne, triées par coût croissant
+    vector<vector<int>> sorted_cols(left);
+    vector<int> distinct_costs;
+    for (int l = 0; l < left; ++l) {
+        for (int r = 0; r < right; ++r) {
+            if (!is_forbidden(cost(l, r))) {
+                sorted_cols[l].push_back(r);
+                distinct_costs.push_back(cost(l, r));
+            }
+        }
+        sort(sorted_cols[l].begin(), sorted_cols[l].end(), [&](int a, int b) { return cost(l, a) < cost(l, b); });
+    }
+    sort(distinct_costs.begin(), distinct_costs.end());
+    distinct_costs.erase(unique(distinct_costs.begin(), distinct_costs.end()), distinct_costs.end());
+
+    vector<int> match_row(left, -1);
+    vector<int> match_col(right, -1);
+    vector<int> start(left + 1);
+    vector<int> adj;
+
+    // Test de réalisabilité d'un seuil, en réutilisant le couplage précédent
+    auto feasible = [&](int threshold) {
+        adj.clear();
+        for (int l = 0; l < left; ++l) {
+            start[l] = adj.size();
+            for (int r: sorted_cols[l]) {
+                if (cost(l, r) > threshold)
+                    break; // Les colonnes suivantes sont plus chères
+                adj.push_back(r);
+            }
+            // Retirer l'association courante si elle dépasse le nouveau seuil
+            if (match_row[l] != -1 && cost(l, match_row[l]) > threshold) {
+                match_col[match_row[l]] = -1;
+                match_row[l] = -1;
+            }
+        }
+        start[left] = adj.size();
+        return hopcroft_karp(start, adj, match_row, match_col) == left;
+    };
+
+    if (distinct_costs.empty() || !feasible(distinct_costs.back()))
+        stop("No complete assignment exists with the allowed entries");
+    vector<int> best_match = match_row;
+
+    // Dichotomie sur l'indice du seuil parmi les coûts distincts
+    int low = 0;
+    int high = distinct_costs.size() - 1;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (feasible(distinct_costs[middle])) {
+            high = middle;
+            best_match = match_row;
+        }
+        else {
+            low = middle + 1;
+        }
+    }
+    int bottleneck = distinct_costs[high];
+
+    vector<vector<int>> assignment(rows, vector<int>(cols, 0));
+    for (int l = 0; l < left; ++l) {
+        if (transposed)
+            assignment[best_match[l]][l] = 1;
+        else
+            assignment[l][best_match[l]] = 1;
+    }
+
+    if (verbose) {
+        print("Bottleneck : ", bottleneck);
+        print("Assignments Matrix:");
+        print(assignment);
+    }
+
+    return List::create(
+        Named("assignment") = assignment,
+        Named("bottleneck") = bottleneck
+    );
+}
+
+
+/**
+ * @brief Découpe l'intervalle [0, size) en blocs contigus et applique une fonction à chaque bloc dans un thread.
+ * 
+ * @tparam Function Le type de la fonction, appelée avec (indice du bloc, début, fin).
+ * @param size La taille de l'intervalle.
+ * @param threads Le nombre de blocs et de threads.
+ * @param function La fonction à appliquer.
+ */
+template<typename Function>
+void parallel_chunks(size_t size, int threads, Function function)
+{
+    size_t chunk = (size + threads - 1) / threads;
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t)
+        pool.emplace_back(function, t, min(size, t * chunk), min(size, (t + 1) * chunk));
+    function(0, 0, min(size, chunk)); // Le thread appelant traite le premier bloc
+    for (auto& t: pool)
+        t.join();
+}
+
+
+/**
+ * @brief Index compact des étiquettes distinctes d'un vecteur d'entiers.
+ * 
+ * Chaque étiquette présente reçoit un identifiant dans [0, size()) selon l'ordre croissant des étiquettes. Quand
+ * l'étendue des étiquettes ne dépasse pas une constante fixe, l'identifiant est lu dans une table directe ; sinon
+ * il est cherché par dichotomie dans la liste triée. Au-delà de cette constante, la mémoire ne dépend donc que du
+ * nombre d'étiquettes distinctes, quelle que soit leur étendue.
+ */
+struct LabelIndex {
+    vector<int> labels;   // Étiquettes distinctes triées
+    long long offset = 0; // Plus petite étiquette (table directe)
+    vector<int> dense;    // Identifiant de chaque étiquette - offset, -1 si absente (vide si non utilisée)
+
+    int size() const { return labels.size(); }
+
+    int operator()(int label) const
+    {
+        if (!dense.empty()) {
+            long long index = (long long)label - offset;
+            return index < 0 || index >= (long long)dense.size() ? -1 : dense[index];
+        }
+        auto it = lower_bound(labels.begin(), labels.end(), label);
+        return it == labels.end() || *it != label ? -1 : int(it - labels.begin());
+    }
+};
+
+
+/**
+ * @brief Construit l'index des étiquettes des points dont les deux étiquettes sont renseignées.
+ * 
+ * @param data Les étiquettes à indexer.
+ * @param other Les étiquettes de l'autre vecteur (un point est ignoré si l'une des deux vaut NA).
+ * @param n Le nombre de points.
+ * @param threads Le nombre de threads.
+ * @return L'index des étiquettes distinctes.
+ */
+LabelIndex build_label_index(const int* data, const int* other, size_t n, int threads)
+{
+    const long long max_dense = 1 << 20; // Étendue maximale pour une table directe, indépendante de n
+
+    vector<int> local_min(threads, numeric_limits<int>::max()), local_max(threads, numeric_limits<int>::min());
+    parallel_chunks(n, threads, [&](int t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (data[i] == NA_INTEGER || other[i] == NA_INTEGER)
+                continue;
+            local_min[t] = min(local_min[t], data[i]);
+            local_max[t] = max(local_max[t], data[i]);
+        }
+    });
+    LabelIndex index;
+    int low = *min_element(local_min.begin(), local_min.end());
+    int high = *max_element(local_max.begin(), local_max.end());
+    if (low > high)
+        return index;
+    long long range = (long long)high - low + 1; // Sans débordement même pour des étiquettes extrêmes
+
+    vector<vector<int>> local_labels(threads);
+    if (range <= max_dense) {
+        // Étendue raisonnable : marquage des étiquettes présentes par thread
+        vector<vector<char>> present(threads);
+        parallel_chunks(n, threads, [&](int t, size_t begin, size_t end) {
+            present[t].assign(range, 0);
+            for (size_t i = begin; i < end; ++i)
+                if (data[i] != NA_INTEGER && other[i] != NA_INTEGER)
+                    present[t][(long long)data[i] - low] = 1;
+        });
+        // Union des marquages dans le premier tableau, par tranches de l'étendue
+        parallel_chunks(range, threads, [&](int, size_t begin, size_t end) {
+            for (size_t t = 1; t < present.size(); ++t)
+                for (size_t l = begin; l < end; ++l)
+                    present[0][l] |= present[t][l];
+        });
+        index.offset = low;
+        index.dense.assign(range, -1);
+        for (long long l = 0; l < range; ++l) {
+            if (present[0][l]) {
+                index.dense[l] = index.labels.size();
+                index.labels.push_back(low + l);
+            }
+        }
+        return index;
+    }
+
+    // Étendue trop grande : étiquettes distinctes de chaque bloc, puis fusion
+    parallel_chunks(n, threads, [&](int t, size_t begin, size_t end) {
+        vector<int>& labels = local_labels[t];
+        for (size_t i = begin; i < end; ++i)
+            if (data[i] != NA_INTEGER && other[i] != NA_INTEGER)
+                labels.push_back(data[i]);
+        sort(labels.begin(), labels.end());
+        labels.erase(unique(labels.begin(), labels.end()), labels.end());
+    });
+    for (const auto& labels: local_labels)
+        index.labels.insert(index.labels.end(), labels.begin(), labels.end());
+    sort(index.labels.begin(), index.labels.end());
+    index.labels.erase(unique(index.labels.begin(), index.labels.end()), index.labels.end());
+    return index;
+}
+
+
+/**
+ * @brief Associe les clusters aux classes à partir de deux vecteurs d'étiquettes entières et évalue la précision.
+ * 
+ * La table de contingence clusters/classes est construite en parallèle sur des blocs du vecteur, chaque thread
+ * remplissant sa propre table avant la réduction. Le coût d'une association est le nombre de points du cluster
+ * qui n'appartiennent pas à la classe, si bien que l'algorithme hongrois maximise le nombre de points bien
+ * étiquetés. Les étiquettes sont d'abord compactées en identifiants distincts, si bien que la taille des tables ne
+ * dépend que du nombre d'étiquettes présentes et non de leur étendue. Les étiquettes remappées et la précision sont calculées dans une dernière passe parallèle, sans
+ * objet intermédiaire de taille n côté R. Les valeurs manquantes sont ignorées.
+ * 
+ * @param classes Les étiquettes de classe de chaque point.
+ * @param clusters Les étiquettes de cluster de chaque point.
+ * @param threads Le nombre de threads à utiliser (0 pour le nombre de coeurs disponibles).
+ * @param verbose Indique si la table de contingence et l'association doivent être affichées (par défaut false).
+ * @return Une liste contenant l'association cluster -> classe, les étiquettes remappées, la précision et la table de contingence.
+ */
+// [[Rcpp::export]]
+List ClusterLabelMatching(IntegerVector classes, IntegerVector clusters, int threads = 0, bool verbose = false)
+{
+    size_t n = classes.size();
+    if (clusters.size() != n)
+        stop("classes and clusters must have the same length");
+    const int* class_data = classes.begin();
+    const int* cluster_data = clusters.begin();
+
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+    threads = max(1, (int)min((size_t)threads, n / 65536 + 1)); // Pas de threads pour les petits vecteurs
+
+    // Première passe : identifiants compacts des étiquettes de classe et de cluster
+    LabelIndex class_index = build_label_index(class_data, cluster_data, n, threads);
+    LabelIndex cluster_index = build_label_index(cluster_data, class_data, n, threads);
+    if (class_index.size() == 0)
+        stop("No labelled point");
+    int class_count = class_index.size();
+    int cluster_count = cluster_index.size();
+    if ((double)cluster_count * class_count > 1e8)
+        stop("Too many distinct labels for a contingency table");
+
+    // Deuxième passe : une table de contingence (cluster x classe) par thread, puis réduction
+    vector<vector<int>> local_tables(threads);
+    parallel_chunks(n, threads, [&](int t, size_t begin, size_t end) {
+        vector<int>& table = local_tables[t];
+        table.assign((size_t)cluster_count * class_count, 0);
+        for (size_t i = begin; i < end; ++i) {
+            if (class_data[i] == NA_INTEGER || cluster_data[i] == NA_INTEGER)
+                continue;
+            table[(size_t)cluster_index(cluster_data[i]) * class_count + class_index(class_data[i])]++;
+        }
+    });
+    vector<vector<int>> contingency(cluster_count, vector<int>(class_count, 0));
+    int max_count = 0;
+    for (int c = 0; c < cluster_count; ++c) {
+        for (int k = 0; k < class_count; ++k) {
+            for (const auto& table: local_tables)
+                contingency[c][k] += table[(size_t)c * class_count + k];
+            max_count = max(max_count, contingency[c][k]);
+        }
+    }
+
+    // Association : minimiser le nombre de points mal étiquetés
+    vector<vector<int>> cost_matrix(cluster_count, vector<int>(class_count));
+    for (int c = 0; c < cluster_count; ++c)
+        for (int k = 0; k < class_count; ++k)
+            cost_matrix[c][k] = max_count - contingency[c][k];
+    vector<vector<int>> M = Hungarian(cost_matrix);
+
+    vector<int> mapping(cluster_count, NA_INTEGER); // Classe associée à chaque étiquette de cluster
+    for (int c = 0; c < cluster_count; ++c)
+        for (int k = 0; k < class_count; ++k)
+            if (M[c][k] == 1)
+                mapping[c] = class_index.labels[k];
+
+    // Troisième passe : étiquettes remappées et nombre de points bien étiquetés
+    IntegerVector labels(n);
+    int* label_data = labels.begin();
+    vector<size_t> correct(threads, 0);
+    vector<size_t> labelled(threads, 0);
+    parallel_chunks(n, threads, [&](int t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            int cluster = cluster_data[i];
+            int id = cluster == NA_INTEGER ? -1 : cluster_index(cluster);
+            label_data[i] = id < 0 ? NA_INTEGER : mapping[id];
+            if (class_data[i] != NA_INTEGER && cluster != NA_INTEGER) {
+                labelled[t]++;
+                if (label_data[i] == class_data[i])
+                    correct[t]++;
+            }
+        }
+    });
+    double accuracy = (double)accumulate(correct.begin(), correct.end(), (size_t)0)
+                    / accumulate(labelled.begin(), labelled.end(), (size_t)0);
+
+    const vector<int>& cluster_labels = cluster_index.labels;
+
+    if (verbose) {
+        print("Contingency Matrix:");
+        print(contingency);
+        print("Clusters : ");
+        print(cluster_labels);
+        print("Classes : ");
+        print(mapping);
+        print("Accuracy : ", accuracy);
+    }
+
+    return List::create(
+        Named("clusters") = cluster_labels,
+        Named("mapping") = mapping,
+        Named("labels") = labels,
+        Named("accuracy") = accuracy,
+        Named("contingency") = contingency
+    );
+}
+
+
+/**
+ * @brief Résout le problème d'affectation avec capacités : chaque colonne j peut recevoir jusqu'à capacity[j] lignes.
+ * 
+ * Chaque ligne est ajoutée par un plus court chemin augmentant (Dijkstra sur les coûts réduits c - u - v) dans le
+ * graphe où une colonne pleine mène aux lignes qui l'occupent. Le chemin s'arrête à la première colonne ayant
+ * encore de la capacité, puis les potentiels sont mis à jour pour garder des coûts réduits positifs. La matrice
+ * n x m n'est jamais dupliquée : une colonne reste unique et garde seulement un compteur de capacité restante.
+ * Les potentiels de lignes partent des minima de lignes, comme la réduction de l'étape 1.
+ * 
+ * @tparam T Le type des éléments dans la matrice.
+ * @param matrix La matrice de coûts (n x m), les associations interdites valant la valeur maximale de T.
+ * @param capacity La capacité de chaque colonne.
+ * @param col_of La colonne associée à chaque ligne (mis à jour par référence).
+ * @param token Le jeton d'annulation optionnel.
+ * @return false si toutes les lignes ne peuvent pas être associées ou si la résolution a été annulée, sinon true.
+ */
+template<typename T>
+bool capacitated_assignment(const vector<vector<T>>& matrix, const vector<int>& capacity, vector<int>& col_of, CancellationToken* token = nullptr)
+{
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+    const long long unreached = numeric_limits<long long>::max();
+
+    // Potentiels : u part des minima de lignes, v de zéro
+    vector<long long> u(rows, unreached);
+    vector<long long> v(cols, 0);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            if (!is_forbidden(matrix[r][c]))
+                u[r] = min(u[r], (long long)matrix[r][c]);
+
+    vector<int> remaining(capacity);
+    col_of.assign(rows, -1);
+    vector<long long> dist(cols);
+    vector<long long> row_dist(rows);
+    vector<int> pred_row(cols);
+    vector<bool> done(cols);
+    vector<vector<int>> members(cols); // Lignes associées à chaque colonne
+    vector<int> reached_rows;
+
+    for (int source = 0; source < rows; ++source) {
+        if (u[source] == unreached)
+            return false; // Ligne sans association autorisée
+
+        for (auto& column: members)
+            column.clear();
+        for (int r = 0; r < rows; ++r)
+            if (col_of[r] != -1)
+                members[col_of[r]].push_back(r);
+
+        fill(dist.begin(), dist.end(), unreached);
+        fill(done.begin(), done.end(), false);
+        reached_rows.assign(1, source);
+        row_dist[source] = 0;
+
+        // Relâcher les arcs d'une ligne atteinte à la distance base
+        auto relax = [&](int r, long long base) {
+            for (int c = 0; c < cols; ++c) {
+                if (done[c] || is_forbidden(matrix[r][c]))
+                    continue;
+                long long candidate = base + matrix[r][c] - u[r] - v[c];
+                if (candidate < dist[c]) {
+                    dist[c] = candidate;
+                    pred_row[c] = r;
+                }
+            }
+        };
+        relax(source, 0);
+
+        int sink = -1;
+        while (sink == -1) {
+            if (token && token->should_stop())
+                return false; // Résolution abandonnée
+
+            // Colonne non traitée la plus proche
+            int closest = -1;
+            for (int c = 0; c < cols; ++c)
+                if (!done[c] && dist[c] != unreached && (closest == -1 || dist[c] < dist[closest]))
+                    closest = c;
+            if (closest == -1)
+                return false; // Aucune colonne libre atteignable
+            done[closest] = true;
+
+            if (remaining[closest] > 0) {
+                sink = closest; // Colonne avec de la capacité : fin du chemin
+            }
+            else {
+                // Colonne pleine : poursuivre depuis chacune des lignes qui l'occupent
+                for (int r: members[closest]) {
+                    row_dist[r] = dist[closest];
+                    reached_rows.push_back(r);
+                    relax(r, dist[closest]);
+                }
+            }
+        }
+
+        // Mise à jour des potentiels des sommets atteints avant le puits
+        long long delta = dist[sink];
+        for (int r: reached_rows)
+            u[r] += delta - row_dist[r];
+        for (int c = 0; c < cols; ++c)
+            if (done[c])
+                v[c] -= delta - dist[c];
+
+        // Inverser le chemin augmentant depuis le puits
+        remaining[sink]--;
+        for (int c = sink;;) {
+            int r = pred_row[c];
+            int previous = col_of[r];
+            col_of[r] = c;
+            if (r == source)
+                break;
+            c = previous;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Implémente l'affectation avec capacités sans réplication des colonnes.
+ * 
+ * @param matrix La matrice de coûts (travailleurs x tâches) du problème.
+ * @param capacity Le nombre maximal de travailleurs acceptés par chaque tâche.
+ * @param verbose Indique si l'affectation doit être affichée (par défaut false).
+ * @return La tâche (à partir de 1) associée à chaque travailleur.
+ */
+// [[Rcpp::export]]
+vector<int> HungarianCapacitated(const vector<vector<int>>& matrix, const vector<int>& capacity, bool verbose = false)
+{
+    if (capacity.size() != matrix[0].size())
+        stop("capacity must have one entry per column");
+    long long total_capacity = 0;
+    for (int c: capacity) {
+        if (c < 0)
+            stop("capacity must be non-negative");
+        total_capacity += c;
+    }
+    if (total_capacity < (long long)matrix.size())
+        stop("Total capacity is smaller than the number of rows");
+
+    vector<int> assignment;
+    if (!capacitated_assignment(matrix, capacity, assignment))
+        stop("No complete assignment exists with the allowed entries and capacities");
+
+    for (auto& col: assignment)
+        col++; // Retour aux indices R
+
+    if (verbose) {
+        print("Assignment : ");
+        print(assignment);
+    }
+    return assignment;
+}
+
+
+/**
+ * @brief Caractéristiques peu coûteuses d'une instance, utilisées pour choisir les moteurs de résolution.
+ */
+struct InstanceFeatures {
+    int rows = 0;               // Nombre de lignes
+    int cols = 0;               // Nombre de colonnes
+    double density = 0;         // Fraction des associations autorisées
+    long long min_cost = 0;     // Plus petit coût autorisé
+    long long cost_range = 0;   // Écart entre le plus grand et le plus petit coût autorisé
+    double zeros_per_row = 0;   // Nombre moyen de zéros par ligne après la réduction de l'étape 1
+};
+
+
+/**
+ * @brief Calcule les caractéristiques d'une matrice de coûts en O(n x m).
+ */
+InstanceFeatures compute_features(const vector<vector<int>>& matrix)
+{
+    InstanceFeatures features;
+    features.rows = matrix.size();
+    features.cols = matrix[0].size();
+
+    long long allowed = 0;
+    long long max_cost = numeric_limits<long long>::min();
+    features.min_cost = numeric_limits<long long>::max();
+    for (const auto& row: matrix) {
+        for (int element: row) {
+            if (is_forbidden(element))
+                continue;
+            allowed++;
+            features.min_cost = min(features.min_cost, (long long)element);
+            max_cost = max(max_cost, (long long)element);
+        }
+    }
+    features.density = (double)allowed / ((double)features.rows * features.cols);
+    features.cost_range = allowed > 0 ? max_cost - features.min_cost : 0;
+
+    // Zéros de la matrice réduite (minimum de ligne puis minimum de colonne)
+    if (features.density == 1.0) {
+        vector<long long> row_min(features.rows);
+        for (int r = 0; r < features.rows; ++r)
+            row_min[r] = *min_element(matrix[r].begin(), matrix[r].end());
+        long long zeros = 0;
+        for (int c = 0; c < features.cols; ++c) {
+            long long col_min = numeric_limits<long long>::max();
+            for (int r = 0; r < features.rows; ++r)
+                col_min = min(col_min, matrix[r][c] - row_min[r]);
+            for (int r = 0; r < features.rows; ++r)
+                if (matrix[r][c] - row_min[r] == col_min)
+                    zeros++;
+        }
+        features.zeros_per_row = (double)zeros / features.rows;
+    }
+    return features;
+}
+
+
+// Moteurs exacts disponibles pour la course
+enum Engine { MUNKRES = 0, COST_SCALING = 1, SHORTEST_PATH = 2, ENGINE_COUNT = 3 };
+const char* engine_names[ENGINE_COUNT] = {"munkres", "cost_scaling", "shortest_path"};
+
+// Nombre de victoires de chaque moteur, pour ajuster les règles de sélection
+atomic<long long> engine_wins[ENGINE_COUNT];
+
+
+/**
+ * @brief Choisit un ou deux moteurs candidats à partir des caractéristiques de l'instance.
+ * 
+ * Les étapes de Munkres ne gèrent ni les coûts négatifs (step1 ne soustrait que des minima positifs) ni les
+ * associations interdites ; elles sont efficaces sur les petites matrices et lorsque la réduction de l'étape 1
+ * laisse beaucoup de zéros. La mise à l'échelle des coûts domine sur les grandes matrices à coûts bornés, et le
+ * plus court chemin augmentant sur les matrices creuses ou de taille intermédiaire. Deux candidats signifient
+ * que le cas est ambigu et qu'ils seront mis en concurrence.
+ */
+vector<Engine> select_engines(const InstanceFeatures& features)
+{
+    int size = max(features.rows, features.cols);
+    bool munkres_allowed = features.density == 1.0 && features.min_cost >= 0;
+
+    if (!munkres_allowed)
+        return size <= 50 ? vector<Engine>{SHORTEST_PATH} : vector<Engine>{COST_SCALING, SHORTEST_PATH};
+    if (size <= 30)
+        return {MUNKRES};
+    if (features.zeros_per_row >= 2.0) // Beaucoup de zéros : peu d'augmentations pour Munkres
+        return size <= 100 ? vector<Engine>{MUNKRES} : vector<Engine>{MUNKRES, COST_SCALING};
+    if (size <= 100)
+        return {SHORTEST_PATH, COST_SCALING};
+    return {COST_SCALING};
+}
+
+
+/**
+ * @brief Exécute un moteur sur la matrice ; renvoie false s'il a été annulé ou si l'instance est irréalisable.
+ */
+bool run_engine(Engine engine, const vector<vector<int>>& matrix, vector<vector<int>>& result, CancellationToken* token)
+{
+    int rows = matrix.size();
+    int cols = matrix[0].size();
+
+    if (engine == MUNKRES) {
+        HungarianState state = make_hungarian_state(matrix);
+        if (!hungarian_run(state, token))
+            return false;
+        result.assign(rows, vector<int>(cols, 0));
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c)
+                result[r][c] = state.M[r][c] == 1 ? 1 : 0;
+        return true;
+    }
+
+    if (engine == COST_SCALING)
+        return cost_scaling_dense(matrix, result, false, token);
+
+    // Plus court chemin augmentant : affectation avec capacités unitaires, sur le plus petit côté
+    bool transposed = rows > cols;
+    vector<vector<int>> oriented(matrix);
+    if (transposed) {
+        oriented.assign(cols, vector<int>(rows));
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c)
+                oriented[c][r] = matrix[r][c];
+    }
+    vector<int> assignment;
+    if (!capacitated_assignment(oriented, vector<int>(oriented[0].size(), 1), assignment, token))
+        return false;
+    result.assign(rows, vector<int>(cols, 0));
+    for (size_t i = 0; i < assignment.size(); ++i) {
+        if (transposed)
+            result[assignment[i]][i] = 1;
+        else
+            result[i][assignment[i]] = 1;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Résout le problème d'association avec le moteur le plus adapté, ou en faisant courir deux moteurs.
+ * 
+ * Les moteurs candidats sont choisis à partir des caractéristiques de l'instance. Un candidat unique est
+ * exécuté directement dans le thread appelant, son jeton vérifiant les interruptions de l'utilisateur R.
+ * Lorsque deux candidats sont retenus, ils tournent chacun dans un thread avec leur propre jeton d'annulation :
+ * le premier qui termine annule l'autre. Tous les moteurs sont exacts, le premier résultat est donc optimal.
+ * Le thread principal attend la fin des moteurs sur une variable de condition et surveille entre deux attentes
+ * les interruptions de l'utilisateur R. Le moteur gagnant est renvoyé et comptabilisé dans
+ * PortfolioStats. NaiveAlgorithme, compilé séparément, ne fait pas partie des candidats.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si les caractéristiques et le moteur gagnant doivent être affichés (par défaut false).
+ * @return Une liste contenant la matrice d'affectation, le moteur gagnant, les candidats et les caractéristiques.
+ */
+// [[Rcpp::export]]
+List HungarianPortfolio(const vector<vector<int>>& matrix, bool verbose = false)
+{
+    InstanceFeatures features = compute_features(matrix);
+    vector<Engine> candidates = select_engines(features);
+
+    size_t count = candidates.size();
+    vector<CancellationToken> tokens(count);
+    vector<vector<vector<int>>> results(count);
+    atomic<int> winner(-1);
+    bool interrupted = false;
+
+    if (count == 1) {
+        // Pas de course : le moteur tourne dans le thread appelant, qui peut interroger R
+        tokens[0].interrupt = user_interrupted;
+        if (run_engine(candidates[0], matrix, results[0], &tokens[0]))
+            winner = 0;
+        else
+            interrupted = tokens[0].cancelled;
+    }
+    else {
+        mutex race_lock;
+        condition_variable race_done;
+        size_t finished = 0; // Protégé par race_lock
+
+        vector<thread> pool;
+        for (size_t e = 0; e < count; ++e) {
+            pool.emplace_back([&, e]() {
+                if (run_engine(candidates[e], matrix, results[e], &tokens[e])) {
+                    int expected = -1;
+                    if (winner.compare_exchange_strong(expected, (int)e)) {
+                        // Premier résultat optimal : annuler les autres moteurs
+                        for (size_t other = 0; other < count; ++other)
+                            if (other != e)
+                                tokens[other].cancel();
+                    }
+                }
+                {
+                    lock_guard<mutex> guard(race_lock);
+                    finished++;
+                }
+                race_done.notify_one();
+            });
+        }
+
+        // Attendre la fin des moteurs en surveillant les interruptions de l'utilisateur
+        unique_lock<mutex> lock(race_lock);
+        while (!race_done.wait_for(lock, milliseconds(10), [&]() { return finished == count; })) {
+            if (!interrupted && user_interrupted()) {
+                interrupted = true;
+                for (auto& token: tokens)
+                    token.cancel();
+            }
+        }
+        lock.unlock();
+        for (auto& t: pool)
+            t.join();
+    }
+
+    if (interrupted && winner == -1)
+        stop("Interrupted");
+    if (winner == -1)
+        stop("No complete assignment exists with the allowed entries");
+
+    Engine engine = candidates[winner];
+    engine_wins[engine]++;
+
+    vector<string> candidate_names;
+    for (Engine candidate: candidates)
+        candidate_names.push_back(engine_names[candidate]);
+
+    if (verbose) {
+        cout << "Features : n = " << features.rows << " x " << features.cols << ", density = " << features.density
+             << ", cost range = " << features.cost_range << ", zeros per row = " << features.zeros_per_row << endl;
+        print("Candidates : ");
+        print(candidate_names);
+        print("Winner : ", engine_names[engine]);
+    }
+
+    return List::create(
+        Named("assignment") = results[winner],
+        Named("engine") = string(engine_names[engine]),
+        Named("candidates") = candidate_names,
+        Named("features") = List::create(
+            Named("rows") = features.rows,
+            Named("cols") = features.cols,
+            Named("density") = features.density,
+            Named("cost_range") = (double)features.cost_range,
+            Named("zeros_per_row") = features.zeros_per_row
+        )
+    );
+}
+
+
+/**
+ * @brief Renvoie le nombre de victoires de chaque moteur dans HungarianPortfolio.
+ */
+// [[Rcpp::export]]
+List PortfolioStats()
+{
+    return List::create(
+        Named(engine_names[MUNKRES]) = (double)engine_wins[MUNKRES],
+        Named(engine_names[COST_SCALING]) = (double)engine_wins[COST_SCALING],
+        Named(engine_names[SHORTEST_PATH]) = (double)engine_wins[SHORTEST_PATH]
+    );
+}
+
+
+// Cache partagé des résultats de Hungarian
+AssignmentCache hungarian_cache(128, 64 << 20); // 128 entrées, 64 Mo
+
+/**
+ * @brief Appelle Hungarian en réutilisant le résultat d'une matrice identique déjà résolue.
+ * 
+ * Le cache est facultatif : seuls les appels passant par cette fonction le consultent. Les moteurs internes
+ * (HungarianBlocks, HungarianPortfolio, ClusterLabelMatching) appellent directement le solveur.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si les étapes doivent être affichées lors d'un calcul (par défaut false).
+ * @return La matrice d'affectation, identique à celle renvoyée par Hungarian.
+ */
+// [[Rcpp::export]]
+vector<vector<int>> HungarianCached(const vector<vector<int>>& matrix, bool verbose = false)
+{
+    uint64_t key = hash_matrix(matrix);
+    vector<vector<int>> result;
+    if (hungarian_cache.lookup(matrix, key, result)) {
+        if (verbose)
+            print("Cache hit");
+        return result;
+    }
+    result = Hungarian(matrix, verbose);
+    hungarian_cache.store(matrix, key, result);
+    return result;
+}
+
+/**
+ * @brief Renvoie les compteurs du cache de Hungarian (succès, échecs, taille, capacité, octets occupés et budget).
+ */
+// [[Rcpp::export]]
+List HungarianCacheStats()
+{
+    return hungarian_cache.stats();
+}
+
+/**
+ * @brief Vide le cache de Hungarian et remet ses compteurs à zéro.
+ */
+// [[Rcpp::export]]
+void HungarianCacheClear()
+{
+    hungarian_cache.clear();
+}
+
+/**
+ * @brief Modifie le nombre maximal d'entrées du cache de Hungarian (0 désactive le cache).
+ */
+// [[Rcpp::export]]
+void HungarianCacheCapacity(int capacity)
+{
+    hungarian_cache.set_capacity(max(0, capacity));
+}
+
+/**
+ * @brief Modifie le nombre maximal d'octets occupés par les matrices du cache de Hungarian (0 désactive le cache).
+ */
+// [[Rcpp::export]]
+void HungarianCacheMaxBytes(double max_bytes)
+{
+    hungarian_cache.set_byte_capacity(max_bytes <= 0 ? 0 : max_bytes >= (double)numeric_limits<size_t>::max() ? numeric_limits<size_t>::max() : (size_t)max_bytes);
+}
+
+
+// Fonction pour générer une matrice de taille n x n en fonction de k
+vector<vector<int>> generateMatrix(int n, int k) {
+    // Initialisation de la matrice avec des valeurs nulles
+    vector<vector<int>> matrix(n, vector<int>(n, 0));
+
+    // Parcours de chaque élément de la matrice
+    for (int i = 0; i < n * n; ++i) {
+        // Calcul du numéro de ligne et de colonne en fonction de l'indice i
+        int row = i / n;
+        int col = i % n;
+
+        // Calcul de la valeur de la cellule en fonction de i, row, col et k
+        matrix[row][col] = i + (row + col) % k;
+    }
+
+    // Retourne la matrice générée
+    return matrix;
+}
+
+// Fonction pour compter les zéros étoilés après les étapes 1 et 2 (chaque zéro manquant coûtera une augmentation)
+int countInitialStars(vector<vector<int>> matrix, bool maximum_matching) {
+    adjust_matrix(matrix);
+    size_t sz = matrix.size();
+    vector<vector<int>> M(sz, vector<int>(sz, 0));
+    vector<int> RowCover(sz, 0);
+    vector<int> ColCover(sz, 0);
+    int step = 1;
+
+    step1(matrix, step);
+    if (maximum_matching)
+        step2_maximum_matching(matrix, M, step);
+    else
+        step2(matrix, M, RowCover, ColCover, step);
+
+    // Compter les zéros étoilés
+    int stars = 0;
+    for (const auto& row : M)
+        stars += count(row.begin(), row.end(), 1);
+    return stars;
+}
+
+int main() {
+    vector<vector<int>> matrix_test = generateMatrix(6, 4);
+    print(matrix_test);
+
+    // Définir la matrice de coût
+    vector<vector<int>> matrix = generateMatrix(100, 10);
+
+    // Nombre de fois à exécuter l'algorithme
+    int num_executions = 100;
+    
+    // Vecteur pour stocker les temps d'exécution
+    vector<double> execution_times(num_executions);
+
+    // Exécuter l'algorithme plusieurs fois et mesurer le temps d'exécution à chaque fois
+    for (int i = 0; i < num_executions; ++i) {
+        auto start = chrono::steady_clock::now();
+        Hungarian(matrix);
+        auto end = chrono::steady_clock::now();
+        chrono::duration<double, milli> duration = end - start;
+        execution_times[i] = duration.count();
+    }
+
+    // Calculer la moyenne des temps d'exécution
+    double mean_execution_time = accumulate(execution_times.begin(), execution_times.end(), 0.0) / num_executions;
+
+    // Calculer l'écart type
+    double variance = 0.0;
+    for (double time : execution_times) {
+        variance += pow(time - mean_execution_time, 2);
+    }
+    variance /= num_executions;
+    double standard_deviation = sqrt(variance);
+
+    // Calculer l'intervalle de confiance à 95%
+    double confidence_interval = 1.96 * (standard_deviation / sqrt(num_executions));
+
+    // Afficher les résultats
+    cout << "Moyenne du temps d'execution : " << mean_execution_time << " millisecondes" << endl;
+    cout << "Intervalle de confiance (95%) : [" << mean_execution_time - confidence_interval
+              << ", " << mean_execution_time + confidence_interval << "] millisecondes" << endl;
+
+    // Mêmes exécutions avec le cache : seule la première résout réellement le problème
+    HungarianCacheClear();
+    for (int i = 0; i < num_executions; ++i) {
+        auto start = chrono::steady_clock::now();
+        HungarianCached(matrix);
+        auto end = chrono::steady_clock::now();
+        chrono::duration<double, milli> duration = end - start;
+        execution_times[i] = duration.count();
+    }
+    cout << "Moyenne du temps d'execution avec cache : "
+         << accumulate(execution_times.begin(), execution_times.end(), 0.0) / num_executions << " millisecondes" << endl;
+
+    // Comparer l'algorithme hongrois et la mise à l'échelle des coûts sur plusieurs tailles de matrices aléatoires
+    mt19937 generator(42);
+    uniform_int_distribution<int> cost_distribution(0, 999);
+    for (int n : {50, 100, 200, 400}) {
+        vector<vector<int>> sweep_matrix(n, vector<int>(n));
+        for (auto& row: sweep_matrix)
+            for (auto& element: row)
+                element = cost_distribution(generator);
+
+        auto start = chrono::steady_clock::now();
+        Hungarian(sweep_matrix);
+        chrono::duration<double, milli> hungarian_time = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        Hungarian(sweep_matrix, false, true);
+        chrono::duration<double, milli> matching_time = chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        HungarianCostScaling(sweep_matrix);
+        chrono::duration<double, milli> cost_scaling_time = chrono::steady_clock::now() - start;
+
+        // Augmentations économisées par le couplage maximal initial
+        int saved_augmentations = countInitialStars(sweep_matrix, true) - countInitialStars(sweep_matrix, false);
+
+        cout << "n = " << n << " : Hungarian " << hungarian_time.count() << " ms, Hungarian (Hopcroft-Karp) "
+             << matching_time.count() << " ms (" << saved_augmentations << " augmentations economisees), CostScaling "
+             << cost_scaling_time.count() << " ms" << endl;
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -4,12 +4,15 @@
 #include <numeric> // Inclure l'en-tête pour la fonction iota
 #include <limits>
 #include <utility>
+#include <cstdint>
 
 using namespace std;
 
 #include <Rcpp.h>
 using namespace Rcpp;
 
+#include "AssignmentCache.h" // Cache des résultats partagé avec Hungarian.cpp
+
 // Fonction pour imprimer une chaîne de caractères
 void print(const string& message) {
     cout << message << endl; // Affiche la chaîne de caractères suivie d'un saut de ligne
@@ -133,6 +136,70 @@ vector<vector<int>> NaiveAlgorithme(const vector<vector<int>>& matrix, bool verb
     return adjacencyMatrix;
 }
 
+// Cache partagé des résultats de NaiveAlgorithme
+AssignmentCache naive_cache(128, 64 << 20); // 128 entrées, 64 Mo
+
+/**
+ * @brief Appelle NaiveAlgorithme en réutilisant le résultat d'une matrice identique déjà résolue.
+ * 
+ * Le cache est facultatif : seuls les appels passant par cette fonction le consultent.
+ * 
+ * @param matrix La matrice d'entrée du problème.
+ * @param verbose Indique si les étapes doivent être affichées lors d'un calcul (par défaut false).
+ * @return La matrice d'affectation, identique à celle renvoyée par NaiveAlgorithme.
+ */
+// [[Rcpp::export]]
+vector<vector<int>> NaiveAlgorithmeCached(const vector<vector<int>>& matrix, bool verbose = false)
+{
+    uint64_t key = hash_matrix(matrix);
+    vector<vector<int>> result;
+    if (naive_cache.lookup(matrix, key, result)) {
+        if (verbose)
+            print("Cache hit");
+        return result;
+    }
+    result = NaiveAlgorithme(matrix, verbose);
+    naive_cache.store(matrix, key, result);
+    return result;
+}
+
+/**
+ * @brief Renvoie les compteurs du cache de NaiveAlgorithme (succès, échecs, taille, capacité, octets occupés et budget).
+ */
+// [[Rcpp::export]]
+List NaiveCacheStats()
+{
+    return naive_cache.stats();
+}
+
+/**
+ * @brief Vide le cache de NaiveAlgorithme et remet ses compteurs à zéro.
+ */
+// [[Rcpp::export]]
+void NaiveCacheClear()
+{
+    naive_cache.clear();
+}
+
+/**
+ * @brief Modifie le nombre maximal d'entrées du cache de NaiveAlgorithme (0 désactive le cache).
+ */
+// [[Rcpp::export]]
+void NaiveCacheCapacity(int capacity)
+{
+    naive_cache.set_capacity(max(0, capacity));
+}
+
+/**
+ * @brief Modifie le nombre maximal d'octets occupés par les matrices du cache de NaiveAlgorithme (0 désactive le cache).
+ */
+// [[Rcpp::export]]
+void NaiveCacheMaxBytes(double max_bytes)
+{
+    naive_cache.set_byte_capacity(max_bytes <= 0 ? 0 : max_bytes >= (double)numeric_limits<size_t>::max() ? numeric_limits<size_t>::max() : (size_t)max_bytes);
+}
+
+
 int main(){
     // Exemple d'utilisation
     vector<vector<int>> matrix = {{2, 1, 0}, {0, 0, 3}, {3, 0, 2}};